@@ -0,0 +1,95 @@
+#include "gencc.h"
+
+// 1チャンクあたりの既定サイズ
+#define ARENA_CHUNK_SIZE (1 << 20)
+
+// すべての割り当てをこの境界に揃える
+#define ARENA_ALIGN 8
+
+struct ArenaChunk {
+    ArenaChunk *next; // 前に確保したチャンク
+    long size;        // dataのバイト数
+    char data[];
+};
+
+// チャンクを新しく確保してアリーナに繋げる．
+// callocで確保するので，割り当てたメモリはゼロで初期化されている．
+static void new_chunk(Arena *arena, long size) {
+    if (size < ARENA_CHUNK_SIZE)
+        size = ARENA_CHUNK_SIZE;
+
+    ArenaChunk *chunk = calloc(1, sizeof(ArenaChunk) + size);
+    if (!chunk)
+        error("%s: out of memory", arena->name);
+    chunk->size = size;
+    chunk->next = arena->chunks;
+    arena->chunks = chunk;
+    arena->ptr = chunk->data;
+    arena->end = chunk->data + size;
+    arena->nchunks++;
+    arena->live += size;
+    if (arena->peak < arena->live)
+        arena->peak = arena->live;
+}
+
+// アリーナからsizeバイトを割り当てる．
+// 返すメモリはゼロで初期化されている．
+void *arena_alloc(Arena *arena, long size) {
+    size = (size + ARENA_ALIGN - 1) & ~(long)(ARENA_ALIGN - 1);
+    if (arena->end - arena->ptr < size)
+        new_chunk(arena, size);
+
+    void *p = arena->ptr;
+    arena->ptr += size;
+    arena->nallocs++;
+    arena->nbytes += size;
+    return p;
+}
+
+// アリーナにコピーした文字列を作る
+char *arena_strndup(Arena *arena, char *p, long len) {
+    char *buf = arena_alloc(arena, len + 1);
+    memcpy(buf, p, len);
+    buf[len] = '\0';
+    return buf;
+}
+
+// アリーナのチャンクをすべて解放する．
+// 統計情報は残すので，解放後でもprint_alloc_statsで表示できる．
+void arena_release(Arena *arena) {
+    ArenaChunk *chunk = arena->chunks;
+    while (chunk) {
+        ArenaChunk *next = chunk->next;
+        free(chunk);
+        chunk = next;
+    }
+    arena->chunks = NULL;
+    arena->ptr = NULL;
+    arena->end = NULL;
+    arena->live = 0;
+}
+
+// 最後に確保したチャンクだけを残して，アリーナを空にする．
+// 残したチャンクは使った範囲をゼロに戻すので，次の割り当てもゼロで初期化されている．
+void arena_reset(Arena *arena) {
+    ArenaChunk *chunk = arena->chunks;
+    if (!chunk)
+        return;
+
+    ArenaChunk *p = chunk->next;
+    while (p) {
+        ArenaChunk *next = p->next;
+        free(p);
+        p = next;
+    }
+    memset(chunk->data, 0, arena->ptr - chunk->data);
+    chunk->next = NULL;
+    arena->live = chunk->size;
+    arena->ptr = chunk->data;
+    arena->end = chunk->data + chunk->size;
+}
+
+void print_alloc_stats(Arena *arena) {
+    fprintf(stderr, "%-10s %10ld allocs %12ld bytes %6ld chunks %12ld peak\n",
+            arena->name, arena->nallocs, arena->nbytes, arena->nchunks, arena->peak);
+}
@@ -0,0 +1,244 @@
+#include "gencc.h"
+
+// コンパイル結果のキャッシュ．
+//
+// 入力の内容，コンパイラのバージョンと実行ファイル，出力に影響するオプションから
+// 128ビットのハッシュを計算し，それをファイル名にしてアセンブリを保存する．
+// 同じ入力をもう一度コンパイルするときは，トークナイズもパースもせずに
+// 保存したファイルをそのまま返す．
+//
+// ファイルはハッシュの先頭1バイトで256個のサブディレクトリに振り分ける．
+// 使うたびに更新時刻を今にして，サブディレクトリが上限を超えたら
+// 更新時刻の古いものから消す（LRU）．
+
+#define GENCC_VERSION "0.1"
+
+// 上限を超えたら，この割合まで減らす
+#define TRIM_RATIO 0.9
+
+// 書きかけのまま残った一時ファイルは，この秒数が経ったら消す
+#define STALE_TMP_SECS 3600
+
+typedef struct {
+    char *dir;              // NULLならキャッシュを使わない
+    long max_size;          // キャッシュ全体の上限（バイト）
+    unsigned long seed[2];  // バージョンとオプションまでのハッシュ
+
+    atomic_long hits;
+    atomic_long misses;
+    atomic_long stores;
+    atomic_long evictions;
+} Cache;
+
+static Cache cache;
+
+static unsigned long rotl(unsigned long x, int r) {
+    return (x << r) | (x >> (64 - r));
+}
+
+// 8バイトずつ2系統のハッシュに混ぜる
+void hash_bytes(unsigned long h[2], char *p, long len) {
+    unsigned long a = h[0];
+    unsigned long b = h[1];
+    long i = 0;
+    for (; i + 8 <= len; i += 8) {
+        unsigned long w;
+        memcpy(&w, p + i, 8);
+        a = rotl((a ^ w) * 0x9E3779B97F4A7C15ul, 29);
+        b = rotl((b + w) * 0xC2B2AE3D27D4EB4Ful, 31);
+    }
+
+    unsigned long w = 0;
+    memcpy(&w, p + i, len - i);
+    h[0] = rotl((a ^ w ^ len) * 0x9E3779B97F4A7C15ul, 29);
+    h[1] = rotl((b + w + len) * 0xC2B2AE3D27D4EB4Ful, 31);
+}
+
+static unsigned long fmix(unsigned long h) {
+    h ^= h >> 33;
+    h *= 0xFF51AFD7ED558CCDul;
+    h ^= h >> 33;
+    h *= 0xC4CEB9FE1A85EC53ul;
+    h ^= h >> 33;
+    return h;
+}
+
+// キャッシュを有効にする．dirがNULLなら環境変数GENCC_CACHE_DIRを使う．
+// flagsには出力に影響するオプションを渡す．
+void cache_init(char *dir, long max_size, char *flags) {
+    if (!dir)
+        dir = getenv("GENCC_CACHE_DIR");
+    if (!dir || !*dir)
+        return;
+
+    if (mkdir(dir, 0755) && errno != EEXIST)
+        error("cannot create %s: %s", dir, strerror(errno));
+    cache.dir = dir;
+    cache.max_size = max_size;
+
+    // コンパイラを作り直したら古い結果は使わないように，実行ファイルの大きさと時刻も混ぜる
+    struct stat st = {};
+    stat("/proc/self/exe", &st);
+    cache.seed[0] = 0x736F6D6570736575ul;
+    cache.seed[1] = 0x646F72616E646F6Dul;
+    hash_bytes(cache.seed, GENCC_VERSION, strlen(GENCC_VERSION));
+    hash_bytes(cache.seed, (char *)&st.st_size, sizeof(st.st_size));
+    hash_bytes(cache.seed, (char *)&st.st_mtim, sizeof(st.st_mtim));
+    hash_bytes(cache.seed, flags, strlen(flags));
+}
+
+bool cache_enabled() {
+    return cache.dir != NULL;
+}
+
+// p[0..len)とバージョン，オプションからキーを作る
+void cache_key(char *p, long len, unsigned long key[2]) {
+    unsigned long h[2] = { cache.seed[0], cache.seed[1] };
+    hash_bytes(h, p, len);
+    key[0] = fmix(h[0]);
+    key[1] = fmix(h[1] ^ h[0]);
+}
+
+// キャッシュディレクトリの下のパスを作る．keyのファイル名にsuffixを付ける．
+// suffixがNULLならサブディレクトリのパスを返す．
+char *cache_entry_path(unsigned long key[2], char *suffix) {
+    long len = strlen(cache.dir) + (suffix ? strlen(suffix) : 0) + 40;
+    char *buf = malloc(len);
+    if (suffix)
+        snprintf(buf, len, "%s/%02lx/%016lx%016lx%s", cache.dir, key[0] >> 56, key[0], key[1], suffix);
+    else
+        snprintf(buf, len, "%s/%02lx", cache.dir, key[0] >> 56);
+    return buf;
+}
+
+// inputのキーをkeyに設定し，キャッシュにあればその内容をoutに書き込んで真を返す．
+bool cache_lookup(char *input, unsigned long key[2], Buffer *out) {
+    cache_key(input, strlen(input), key);
+    char *path = cache_entry_path(key, ".s");
+    int fd = open(path, O_RDONLY);
+    free(path);
+
+    struct stat st;
+    bool hit = fd >= 0 && !fstat(fd, &st) && buf_copy_file(out, fd, st.st_size);
+    if (hit)
+        futimens(fd, NULL); // LRUのために使った時刻を記録する
+    if (fd >= 0)
+        close(fd);
+
+    if (hit)
+        cache.hits++;
+    else
+        cache.misses++;
+    return hit;
+}
+
+typedef struct {
+    char *name;
+    long size;
+    struct timespec mtime;
+} Entry;
+
+static int compare_mtime(const void *x, const void *y) {
+    const Entry *a = x;
+    const Entry *b = y;
+    if (a->mtime.tv_sec != b->mtime.tv_sec)
+        return a->mtime.tv_sec < b->mtime.tv_sec ? -1 : 1;
+    if (a->mtime.tv_nsec != b->mtime.tv_nsec)
+        return a->mtime.tv_nsec < b->mtime.tv_nsec ? -1 : 1;
+    return 0;
+}
+
+// サブディレクトリの合計が上限を超えていたら，古いものから消す．
+// いま保存したkeepは，それ1つで上限を超えていても消さない．
+static void trim_dir(char *subdir, char *keep) {
+    DIR *d = opendir(subdir);
+    if (!d)
+        return;
+
+    long limit = cache.max_size / 256;
+    long total = 0;
+    long len = 0;
+    long cap = 64;
+    Entry *entries = malloc(sizeof(Entry) * cap);
+    time_t now = time(NULL);
+
+    for (struct dirent *de; (de = readdir(d));) {
+        struct stat st;
+        if (de->d_name[0] == '.' || fstatat(dirfd(d), de->d_name, &st, 0))
+            continue;
+        if (strstr(de->d_name, ".tmp.")) {
+            if (st.st_mtime < now - STALE_TMP_SECS)
+                unlinkat(dirfd(d), de->d_name, 0);
+            continue;
+        }
+
+        if (len == cap) {
+            cap *= 2;
+            entries = realloc(entries, sizeof(Entry) * cap);
+        }
+        entries[len].name = strdup(de->d_name);
+        entries[len].size = st.st_size;
+        entries[len].mtime = st.st_mtim;
+        len++;
+        total += st.st_size;
+    }
+
+    if (total > limit) {
+        qsort(entries, len, sizeof(Entry), compare_mtime);
+        for (long i = 0; i < len && total > limit * TRIM_RATIO; i++) {
+            if (!strcmp(entries[i].name, keep))
+                continue;
+            if (!unlinkat(dirfd(d), entries[i].name, 0))
+                cache.evictions++;
+            total -= entries[i].size;
+        }
+    }
+
+    for (long i = 0; i < len; i++)
+        free(entries[i].name);
+    free(entries);
+    closedir(d);
+}
+
+// keyのファイル名にsuffixを付けて保存する．失敗してもコンパイルには影響しないので無視する．
+// 一時ファイルに書いてから名前を変えるので，読む側が書きかけのファイルを見ることはない．
+void cache_store(unsigned long key[2], char *suffix, char *data, long len) {
+    if (len > cache.max_size)
+        return;
+
+    char *subdir = cache_entry_path(key, NULL);
+    mkdir(subdir, 0755);
+
+    char tmpsuffix[64];
+    snprintf(tmpsuffix, sizeof(tmpsuffix), ".tmp.%d.%lx", getpid(), (unsigned long)pthread_self());
+    char *tmp = cache_entry_path(key, tmpsuffix);
+    char *path = cache_entry_path(key, suffix);
+
+    int fd = open(tmp, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    bool ok = fd >= 0;
+    for (char *p = data; ok && p < data + len;) {
+        ssize_t n = write(fd, p, data + len - p);
+        if (n < 0 && errno == EINTR)
+            continue;
+        ok = n > 0;
+        p += n;
+    }
+    if (fd >= 0)
+        close(fd);
+
+    if (ok && !rename(tmp, path)) {
+        cache.stores++;
+        trim_dir(subdir, strrchr(path, '/') + 1);
+    } else {
+        unlink(tmp);
+    }
+
+    free(tmp);
+    free(path);
+    free(subdir);
+}
+
+void print_cache_stats() {
+    fprintf(stderr, "cache: %ld hits, %ld misses, %ld stores, %ld evictions\n",
+            (long)cache.hits, (long)cache.misses, (long)cache.stores, (long)cache.evictions);
+}
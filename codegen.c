@@ -1,311 +1,423 @@
 #include "gencc.h"
 
-int label_seq = 0;
-char *argreg1[] = { "dil", "sil", "dl", "cl", "r8b", "r9b" };
-char *argreg8[] = { "rdi", "rsi", "rdx", "rcx", "r8", "r9" };
-char *funcname;
-
-void gen(Node *node);
-
-void gen_addr(Node *node) {
-    switch (node->kind) {
-        case ND_VAR: {
-            Var *var = node->var;
-            if (var->is_local) {
-                printf("    mov rax, rbp\n");
-                printf("    sub rax, %ld\n", var->offset);
-                printf("    push rax\n");
-            } else {
-                printf("    push offset %s\n", var->name);
-            }
-            return;
-        }
-        case ND_DEREF:
-            gen(node->lhs);
-            return;
-        case ND_MEMBER:
-            gen_addr(node->lhs);
-            printf("    pop rax\n");
-            printf("    add rax, %d\n", node->member->offset);
-            printf("    push rax\n");
-            return;
-        default:
-            break;
+static Reg argregs[] = { REG_RDI, REG_RSI, REG_RDX, REG_RCX, REG_R8, REG_R9 };
+
+// 真なら各関数のアセンブリの前に中間表現をコメントで出力する
+static bool dump_ir_enabled;
+
+void enable_dump_ir() {
+    dump_ir_enabled = true;
+}
+
+// いまコード生成している関数の状態．
+// 関数ごとに別のスレッドで生成するので，スレッドごとに持つ．
+// ラベルは関数名と関数内の通し番号で作るので，他の関数と衝突しない．
+static _Thread_local char *funcname;
+static _Thread_local Buffer *out;
+static _Thread_local int *loc;          // 仮想レジスタの割り当て先
+static _Thread_local Operand *opnd;     // 仮想レジスタを指す被演算子
+
+// 関数の命令の列．のぞき穴最適化をかけてから出力する
+static _Thread_local Insn *insns;
+static _Thread_local long ninsns;
+static _Thread_local long insns_cap;
+
+// 中間表現は関数ごとに作って捨てる
+static _Thread_local Arena ir_arena = { .name = "ir" };
+
+// アセンブリを1行出力する
+void emit(char *fmt, ...) {
+    va_list ap;
+    va_start(ap, fmt);
+    buf_vformat(out, fmt, ap);
+    va_end(ap);
+}
+
+//
+// 命令の列を作る
+//
+
+static Operand reg(Reg r) {
+    return (Operand){ .kind = OPD_REG, .reg = r, .size = 8 };
+}
+
+// レジスタの下位8ビット
+static Operand reg_low(Operand r) {
+    r.size = 1;
+    return r;
+}
+
+static Operand imm(long val) {
+    return (Operand){ .kind = OPD_IMM, .val = val };
+}
+
+static Operand mem(Reg base, long disp, int size) {
+    return (Operand){ .kind = OPD_MEM, .reg = base, .val = disp, .size = size };
+}
+
+static Operand sym(char *name) {
+    return (Operand){ .kind = OPD_SYM, .sym = name };
+}
+
+static Operand label(long n) {
+    return (Operand){ .kind = OPD_LABEL, .val = n };
+}
+
+static Operand none() {
+    return (Operand){ .kind = OPD_NONE };
+}
+
+static Insn *insn(InsnOp op, Operand a, Operand b) {
+    if (ninsns == insns_cap) {
+        insns_cap = insns_cap ? insns_cap * 2 : 256;
+        insns = realloc(insns, sizeof(Insn) * insns_cap);
     }
-    error_tok(node->tok, "not a variable");
+    Insn *i = &insns[ninsns++];
+    *i = (Insn){ .op = op, .opd = { a, b } };
+    return i;
 }
 
-void load(Type *ty) {
-    printf("    pop rax\n");
-    if (size_of(ty) == 1)
-        printf("    movsx rax, byte ptr [rax]\n");
-    else
-        printf("    mov rax, [rax]\n");
-    printf("    push rax\n");
+static void insn_cc(InsnOp op, CondCode cc, Operand a) {
+    insn(op, a, none())->cc = cc;
 }
 
-void store(Type *ty) {
-    printf("    pop rdi\n");
-    printf("    pop rax\n");
-    if (size_of(ty) == 1)
-        printf("    mov [rax], dil\n");
-    else
-        printf("    mov [rax], rdi\n");
-    printf("    push rdi\n");
+static bool same_opd(Operand a, Operand b) {
+    return a.kind == b.kind && a.reg == b.reg && a.val == b.val;
+}
+
+//
+// 中間表現からのコード生成
+//
+// 仮想レジスタは割り当てられた物理レジスタか，スタックフレームのスピル領域にある．
+// rax, rdx, rdiと引数レジスタは割り当てに使わないので，計算の途中で自由に使ってよい．
+// スタックの深さは関数の中で変わらないので，関数呼び出しの前に
+// RSPを16の倍数に揃え直す必要はない．
+//
+
+static bool in_reg(int r) {
+    return loc[r] >= 0;
+}
+
+// 結果を計算するレジスタ．dがスピルされていればraxで計算して，write_backで書き戻す
+static Operand dst_reg(int d) {
+    return in_reg(d) ? opnd[d] : reg(REG_RAX);
+}
+
+static void write_back(int d, Operand r) {
+    if (!same_opd(opnd[d], r))
+        insn(I_MOV, opnd[d], r);
 }
 
-void gen_lval(Node *node) {
-    if (node->ty->kind == TY_ARRAY)
-        error_tok(node->tok, "not an lvalue");
-    gen_addr(node);
+// rをレジスタで読む．スピルされていればtmpに読み込む
+static Operand src_reg(int r, Reg tmp) {
+    if (in_reg(r))
+        return opnd[r];
+    insn(I_MOV, reg(tmp), opnd[r]);
+    return reg(tmp);
 }
 
-void gen(Node *node) {
-    switch (node->kind) {
-        case ND_NULL:
+// d = a op b．x86の命令は2番地なので，aを結果のレジスタに写してからbを演算する
+static void emit_binary(Ir *ir, InsnOp op) {
+    int a = ir->a;
+    int b = ir->b;
+    Operand dst = dst_reg(ir->d);
+
+    // aを写すとbを壊してしまうので，入れ替えられなければraxで計算する
+    if (in_reg(ir->d) && loc[ir->d] == loc[b]) {
+        if (ir->op != IR_SUB) {
+            b = ir->a;
+            a = ir->b;
+        } else {
+            dst = reg(REG_RAX);
+        }
+    }
+    if (!same_opd(dst, opnd[a]))
+        insn(I_MOV, dst, opnd[a]);
+    insn(op, dst, opnd[b]);
+    write_back(ir->d, dst);
+}
+
+static void emit_cmp(Ir *ir, CondCode cc) {
+    insn(I_CMP, src_reg(ir->a, REG_RAX), opnd[ir->b]);
+    insn_cc(I_SET, cc, reg_low(reg(REG_RAX)));
+    insn(I_MOVZX, dst_reg(ir->d), reg_low(reg(REG_RAX)));
+    write_back(ir->d, dst_reg(ir->d));
+}
+
+static void emit_ir(Ir *ir) {
+    switch (ir->op) {
+        case IR_IMM:
+            insn(I_MOV, dst_reg(ir->d), imm(ir->imm));
+            write_back(ir->d, dst_reg(ir->d));
             return;
-        case ND_IF: {
-            int seq = label_seq++;
-            gen(node->cond);
-            printf("    pop rax\n");
-            printf("    cmp rax, 0\n");
-            if (node->els) {
-                printf("    je .Lelse%d\n", seq);
-                gen(node->then);
-                printf("    jmp .Lend%d\n", seq);
-                printf(".Lelse%d:\n", seq);
-                gen(node->els);
-                printf(".Lend%d:\n", seq);
-            } else {
-                printf("    je .Lend%d\n", seq);
-                gen(node->then);
-                printf(".Lend%d:\n", seq);
-            }
+        case IR_MOV:
+            if (!same_opd(dst_reg(ir->d), opnd[ir->a]))
+                insn(I_MOV, dst_reg(ir->d), opnd[ir->a]);
+            write_back(ir->d, dst_reg(ir->d));
             return;
-        }
-        case ND_WHILE: {
-            int seq = label_seq++;
-            printf(".Lbegin%d:\n", seq);
-            gen(node->cond);
-            printf("    pop rax\n");
-            printf("    cmp rax, 0\n");
-            printf("    je .Lend%d\n", seq);
-            gen(node->then);
-            printf("    jmp .Lbegin%d\n", seq);
-            printf(".Lend%d:\n", seq);
+        case IR_ADD:
+            emit_binary(ir, I_ADD);
             return;
-        }
-        case ND_FOR: {
-            int seq = label_seq++;
-            if (node->init)
-                gen(node->init);
-            printf(".Lbegin%d:\n", seq);
-            if (node->cond) {
-                gen(node->cond);
-                printf("    pop rax\n");
-                printf("    cmp rax, 0\n");
-                printf("    je .Lend%d\n", seq);
-            }
-            gen(node->then);
-            if (node->inc)
-                gen(node->inc);
-            printf("    jmp .Lbegin%d\n", seq);
-            printf(".Lend%d:\n", seq);
+        case IR_SUB:
+            emit_binary(ir, I_SUB);
             return;
-        }
-        case ND_FUNCALL: {
-            int nargs = 0;
-            for (Node *arg = node->args; arg; arg = arg->next) {
-                gen(arg);
-                nargs++;
-            }
-
-            for (int i = nargs - 1; i >= 0; i--)
-                printf("    pop %s\n", argreg8[i]);
-
-            // 関数呼び出しをする前にRSPが16の倍数になっている必要がある．
-            // push, popは8バイトRSPをずらすため，それを補正する
-            int seq = label_seq++;
-            printf("    mov rax, rsp\n");       // rax <= rsp
-            printf("    and rax, 15\n");        // rax <= rax & 0b1111
-            printf("    jnz .Lcall%d\n", seq);  // rax is not 0 => jump .Lcall
-            // if ( rsp 下位4bit = 0b0000 )
-            printf("    mov rax, 0\n");
-            printf("    call %s\n", node->funcname);
-            printf("    jmp .Lend%d\n", seq);
-            // if ( rsp が16の倍数でない )
-            printf("    .Lcall%d:\n", seq);
-            printf("    sub rsp, 8\n");         // rsp <= rsp - 8 : 16の倍数へ
-            printf("    mov rax, 0\n");
-            printf("    call %s\n", node->funcname);
-            printf("    add rsp, 8\n");         // rsp <= rsp + 8 : もとに戻す
-
-            printf(".Lend%d:\n", seq);
-            printf("    push rax\n");
+        case IR_MUL:
+            emit_binary(ir, I_IMUL);
+            return;
+        case IR_DIV:
+            insn(I_MOV, reg(REG_RAX), opnd[ir->a]);
+            insn(I_CQO, none(), none());
+            insn(I_IDIV, opnd[ir->b], none());
+            write_back(ir->d, reg(REG_RAX));
+            return;
+        case IR_EQ:
+            emit_cmp(ir, CC_E);
+            return;
+        case IR_NE:
+            emit_cmp(ir, CC_NE);
+            return;
+        case IR_LT:
+            emit_cmp(ir, CC_L);
+            return;
+        case IR_LE:
+            emit_cmp(ir, CC_LE);
+            return;
+        case IR_ADDR:
+            if (ir->var->is_local)
+                insn(I_LEA, dst_reg(ir->d), mem(REG_RBP, -ir->var->offset, 8));
+            else
+                insn(I_MOV, dst_reg(ir->d), sym(ir->var->name));
+            write_back(ir->d, dst_reg(ir->d));
+            return;
+        case IR_LOAD: {
+            Operand addr = src_reg(ir->a, REG_RAX);
+            insn(ir->size == 1 ? I_MOVSX : I_MOV, dst_reg(ir->d), mem(addr.reg, 0, ir->size));
+            write_back(ir->d, dst_reg(ir->d));
             return;
         }
-        case ND_EXPR_STMT:
-            gen(node->lhs);
-            printf("    add rsp, 8\n"); // genの末尾で使用しない値がpopされているので削除する
-        case ND_BLOCK:
-        case ND_STMT_EXPR: {
-            for (Node *n = node->body; n; n = n->next) {
-                gen(n);
-            }
+        case IR_STORE: {
+            Operand addr = src_reg(ir->a, REG_RAX);
+            Operand val = src_reg(ir->b, REG_RDI);
+            insn(I_MOV, mem(addr.reg, 0, ir->size), ir->size == 1 ? reg_low(val) : val);
             return;
         }
-        case ND_RETURN:
-            gen(node->lhs);
-            printf("    pop rax\n");
-            printf("    jmp .Lreturn.%s\n", funcname);
+        case IR_STORE_ARG: {
+            int size = size_of(ir->var->ty);
+            Operand arg = reg(argregs[ir->imm]);
+            insn(I_MOV, mem(REG_RBP, -ir->var->offset, size), size == 1 ? reg_low(arg) : arg);
             return;
-        default:
-            break;
-    }
-
-    switch (node->kind) {
-        case ND_ADDR:
-            gen_addr(node->lhs);
+        }
+        case IR_ARG:
+            insn(I_MOV, dst_reg(ir->d), reg(argregs[ir->imm]));
+            write_back(ir->d, dst_reg(ir->d));
             return;
-        case ND_DEREF:
-            gen(node->lhs);
-            if (node->ty->kind != TY_ARRAY)
-                load(node->ty);
+        case IR_CALL:
+            // 引数レジスタは割り当てに使わないので，順に読み込んでも壊さない
+            for (int i = 0; i < ir->nargs; i++)
+                insn(I_MOV, reg(argregs[i]), opnd[ir->args[i]]);
+            insn(I_MOV, reg(REG_RAX), imm(0));
+            insn(I_CALL, sym(ir->funcname), none());
+            write_back(ir->d, reg(REG_RAX));
             return;
-        case ND_NUM:
-            printf("    push %ld\n", node->val);
+        case IR_JMP:
+            insn(I_JMP, label(ir->bb1->label), none());
             return;
-        case ND_VAR:
-        case ND_MEMBER:
-            gen_addr(node);
-            if (node->ty->kind != TY_ARRAY)
-                load(node->ty);
+        case IR_BR:
+            insn(I_CMP, opnd[ir->a], imm(0));
+            insn_cc(I_JCC, CC_E, label(ir->bb2->label));
+            insn(I_JMP, label(ir->bb1->label), none());
             return;
-        case ND_ASSIGN:
-            gen_lval(node->lhs);
-            gen(node->rhs);
-            store(node->ty);
+        case IR_RET:
+            if (ir->a)
+                insn(I_MOV, reg(REG_RAX), opnd[ir->a]);
+            insn(I_JMP, label(RETURN_LABEL), none());
             return;
-        default:
-            break;
     }
-
-    gen(node->lhs);
-    gen(node->rhs);
-
-    printf("    pop rdi\n");
-    printf("    pop rax\n");
-
-    switch (node->kind) {
-        case ND_ADD:
-            if (node->ty->base)
-                printf("    imul rdi, %ld\n", size_of(node->ty->base)); // ptr + x => (ptr + x*8)
-            printf("    add rax, rdi\n");
-            break;
-        case ND_SUB:
-            if (node->ty->base)
-                printf("    imul rdi, %ld\n", size_of(node->ty->base)); // ptr - x => (ptr - x*8)
-            printf("    sub rax, rdi\n");
-            break;
-        case ND_MUL:
-            printf("    imul rax, rdi\n");
-            break;
-        case ND_DIV:
-            printf("    cqo\n");
-            printf("    idiv rdi\n");
-            break;
-        case ND_EQ:
-            printf("    cmp rax, rdi\n");
-            printf("    sete al\n");
-            printf("    movzb rax, al\n");
-            break;
-        case ND_NE:
-            printf("    cmp rax, rdi\n");
-            printf("    setne al\n");
-            printf("    movzb rax, al\n");
-            break;
-        case ND_LT:
-            printf("    cmp rax, rdi\n");
-            printf("    setl al\n");
-            printf("    movzb rax, al\n");
-            break;
-        case ND_LE:
-            printf("    cmp rax, rdi\n");
-            printf("    setle al\n");
-            printf("    movzb rax, al\n");
-            break;
-        default:
-            // unreachable
-            error_tok(node->tok, "invalid node");
-    }
-
-    printf("    push rax\n");
 }
 
 void emit_data(Program *prog) {
-    printf(".data\n");
+    emit(".data\n");
 
     for (VarList *vl = prog->global; vl; vl = vl->next) {
         Var *var = vl->var;
-        printf("%s:\n", var->name);
+        emit("%s:\n", var->name);
 
         if (!var->contents) {
-            printf("    .zero %ld\n", size_of(var->ty));
+            emit("    .zero %ld\n", size_of(var->ty));
             continue;
         }
 
+        // 1行の.byteにまとめて出力する
+        buf_puts(out, "    .byte ");
         for (int i = 0; i < var->cont_len; i++) {
-            printf("    .byte %d\n", var->contents[i]);
+            if (i)
+                buf_putc(out, ',');
+            buf_putl(out, var->contents[i]);
         }
+        buf_putc(out, '\n');
     }
 }
 
-void load_arg(Var *var, int idx) {
-    long size = size_of(var->ty);
-    if (size == 1) {
-        printf("    mov [rbp-%ld], %s\n", var->offset, argreg1[idx]);
-    } else {
-        assert(size == 8);
-        printf("    mov [rbp-%ld], %s\n", var->offset, argreg8[idx]);
+// ローカル変数のRBPからのオフセットを決める．レジスタに置いた変数は領域を持たない
+static void assign_lvar_offsets(Function *fn) {
+    long offset = 0;
+    for (VarList *vl = fn->locals; vl; vl = vl->next) {
+        Var *var = vl->var;
+        if (var->reg)
+            continue;
+        offset += size_of(var->ty);
+        var->offset = offset;
     }
+    fn->stack_size = offset;
 }
 
-void emit_text(Program *prog) {
-    printf(".text\n");
+// 1つの関数のコードを生成する
+void emit_function(Function *fn) {
+    funcname = fn->name;
 
-    for (Function *fn = prog->fns; fn; fn = fn->next) {
-        printf(".global %s\n", fn->name);
-        printf("%s:\n", fn->name);
-        funcname = fn->name;
+    IrFunc *f = lower_function(fn, &ir_arena);
+    verify_ir(f);
+    mem2reg(f);
+    verify_ir(f);
+    assign_lvar_offsets(fn);
+    alloc_regs(f);
+    if (dump_ir_enabled)
+        dump_ir(f, out);
 
-        // prologue
-        // 変数26個分の領域を確保する
-        printf("    push rbp\n");
-        printf("    mov rbp, rsp\n");
-        printf("    sub rsp, %ld\n", fn->stack_size);
+    // ローカル変数の下に呼び出し先保存のレジスタの退避場所とスピル領域を置き，
+    // RSPを16の倍数に揃える
+    long offset = fn->stack_size;
+    long saved[NUM_REGS];
+    for (int p = NUM_CALLER_SAVED; p < NUM_REGS; p++)
+        if (f->used_regs & (1u << p))
+            saved[p] = offset += 8;
+    long spill_base = offset;
+    long frame_size = (spill_base + f->nspills * 8 + 15) & ~15L;
 
-        // 関数の引数をスタックにプッシュ
-        int i = 0;
-        for (VarList *vl = fn->params; vl; vl = vl->next) {
-            load_arg(vl->var, i++);
-        }
+    loc = f->loc;
+    opnd = arena_alloc(&ir_arena, sizeof(Operand) * f->nregs);
+    for (int r = 1; r < f->nregs; r++) {
+        if (in_reg(r))
+            opnd[r] = reg(phys_regs[loc[r]]);
+        else
+            opnd[r] = mem(REG_RBP, -(spill_base - loc[r] * 8), 8);
+    }
+
+    // prologue
+    ninsns = 0;
+    insn(I_PUSH, reg(REG_RBP), none());
+    insn(I_MOV, reg(REG_RBP), reg(REG_RSP));
+    insn(I_SUB, reg(REG_RSP), imm(frame_size));
+    for (int p = NUM_CALLER_SAVED; p < NUM_REGS; p++)
+        if (f->used_regs & (1u << p))
+            insn(I_MOV, mem(REG_RBP, -saved[p], 8), reg(phys_regs[p]));
+
+    for (BB *bb = f->bbs; bb; bb = bb->next) {
+        insn(I_LABEL, label(bb->label), none());
+        for (Ir *ir = bb->first; ir; ir = ir->next)
+            emit_ir(ir);
+    }
 
-        // 抽象構文木を下りながらコード生成
-        for (Node *n = fn->node; n; n = n->next) {
-            gen(n);
+    // epilogue
+    // IR_RETからジャンプする
+    insn(I_LABEL, label(RETURN_LABEL), none());
+    for (int p = NUM_CALLER_SAVED; p < NUM_REGS; p++)
+        if (f->used_regs & (1u << p))
+            insn(I_MOV, reg(phys_regs[p]), mem(REG_RBP, -saved[p], 8));
+    insn(I_MOV, reg(REG_RSP), reg(REG_RBP));
+    insn(I_POP, reg(REG_RBP), none());
+    insn(I_RET, none(), none());
+
+    peephole(insns, ninsns, f->nbbs);
+
+    emit(".global %s\n", fn->name);
+    emit("%s:\n", fn->name);
+    print_insns(out, insns, ninsns, funcname);
+
+    arena_reset(&ir_arena);
+}
+
+typedef struct {
+    Context *ctx;
+    Function **fns;
+    Buffer **bufs;
+    atomic_bool failed; // どれかの関数でエラーを報告した
+} TextJob;
+
+// スレッドプールから呼ばれる．i番目の関数を専用のバッファに生成する．
+// ワーカーのスレッドにはbailがないので，エラーはここで受け止めて呼び出し元に知らせる．
+static void gen_function_job(void *arg, long i) {
+    TextJob *job = arg;
+    ctx = job->ctx;
+    if (job->fns[i]->text)
+        return; // 前回のコンパイル結果を使う
+    job->bufs[i] = new_buffer(-1);
+    out = job->bufs[i];
+
+    jmp_buf env;
+    jmp_buf *saved = bail;
+    bail = &env;
+    if (setjmp(env))
+        atomic_store(&job->failed, true);
+    else
+        emit_function(job->fns[i]);
+    bail = saved;
+}
+
+// 関数ごとに並列にコードを生成し，渡された順に連結する．
+// 各関数の出力はスレッド数や実行順によらないので，結果は常に同じになる．
+// poolがNULLなら呼び出し元のスレッドだけで順に生成する．
+void codegen_functions(Function **fns, long nfns, Buffer *buf, ThreadPool *pool) {
+    TextJob job;
+    job.ctx = ctx;
+    job.fns = fns;
+    job.bufs = calloc(nfns, sizeof(Buffer *));
+    atomic_init(&job.failed, false);
+
+    if (pool) {
+        pool_run(pool, nfns, gen_function_job, &job);
+    } else {
+        for (long i = 0; i < nfns; i++)
+            gen_function_job(&job, i);
+    }
+
+    if (atomic_load(&job.failed)) {
+        for (long i = 0; i < nfns; i++)
+            if (job.bufs[i])
+                free_buffer(job.bufs[i]);
+        free(job.bufs);
+        abort_compile();
+    }
+
+    for (long i = 0; i < nfns; i++) {
+        Function *fn = fns[i];
+        if (fn->text) {
+            buf_write(buf, fn->text, fn->text_len);
+            continue;
         }
 
-        // epilogue
-        // ND_RETURN ノードからジャンプする
-        printf(".Lreturn.%s:\n", funcname);
-        printf("    mov rsp, rbp\n");
-        printf("    pop rbp\n");
-        printf("    ret\n");
+        Buffer *text = job.bufs[i];
+        buf_write(buf, text->data, text->len);
+
+        // 増分コンパイルの記録に使うので，関数のアセンブリを残しておく
+        if (ctx->inc) {
+            fn->text = text->data;
+            fn->text_len = text->len;
+            text->data = NULL;
+        }
+        free_buffer(text);
     }
+    free(job.bufs);
 }
 
-void codegen(Program *prog) {
-    printf(".intel_syntax noprefix\n");
+// 関数より前に出力する部分
+void codegen_begin(Buffer *buf) {
+    buf_puts(buf, ".intel_syntax noprefix\n");
+    buf_puts(buf, ".text\n");
+}
+
+// すべての関数の後に，グローバル変数と文字列リテラルを出力する
+void codegen_end(Program *prog, Buffer *buf) {
+    out = buf;
     emit_data(prog);
-    emit_text(prog);
-}
\ No newline at end of file
+}
@@ -0,0 +1,158 @@
+#include "gencc.h"
+
+// 抽象構文木での定数の畳み込み．
+//
+// パーサがノードを作るたびに呼ぶので，子はすでに畳み込まれている．
+// 構文木を改めて辿らないので，深く入れ子になった式でも再帰しない．
+// - 被演算子がどちらも整数の二項演算子は，計算した結果の整数のノードにする
+// - 副作用のない式を0倍するx*0, 0*xは0にする
+// - x+0, 0+x, x-0, x*1, 1*x, x/1は，値として使うところでxに置き換える．
+//   (x+0) = 1 や &(x+0) をエラーのままにするため，ノード自体は書き換えない
+// - 条件が定数のif, while, forは，実行されない側を構文木から除く
+
+static bool is_num(Node *node, long val) {
+    return node->kind == ND_NUM && node->val == val;
+}
+
+// 読んでも副作用のない式
+static bool is_pure(Node *node) {
+    return node->kind == ND_NUM || node->kind == ND_VAR;
+}
+
+// 実行時と同じく2の補数で桁あふれさせる．
+// 0での割り算と桁あふれする割り算は実行時に任せるので偽を返す
+static bool eval(NodeKind kind, long lhs, long rhs, long *val) {
+    unsigned long a = lhs;
+    unsigned long b = rhs;
+    switch (kind) {
+        case ND_ADD: *val = a + b; return true;
+        case ND_SUB: *val = a - b; return true;
+        case ND_MUL: *val = a * b; return true;
+        case ND_DIV:
+            if (rhs == 0 || (lhs == LONG_MIN && rhs == -1))
+                return false;
+            *val = lhs / rhs;
+            return true;
+        case ND_EQ: *val = lhs == rhs; return true;
+        case ND_NE: *val = lhs != rhs; return true;
+        case ND_LT: *val = lhs < rhs; return true;
+        case ND_LE: *val = lhs <= rhs; return true;
+        default: return false;
+    }
+}
+
+// 値として使う式を簡約する．恒等式ならその被演算子を返す．
+// 型が変わるとポインタの演算の意味が変わるので，同じ型のときだけ置き換える
+NodeId simplify(NodeId id) {
+    Node *node = NODE(id);
+    if (node->kind != ND_ADD && node->kind != ND_SUB && node->kind != ND_MUL && node->kind != ND_DIV)
+        return id;
+
+    Node *lhs = NODE(node->lhs);
+    Node *rhs = NODE(node->rhs);
+    NodeId x = 0;
+    switch (node->kind) {
+        case ND_ADD:
+            x = is_num(rhs, 0) ? node->lhs : is_num(lhs, 0) ? node->rhs : 0;
+            break;
+        case ND_SUB:
+            x = is_num(rhs, 0) ? node->lhs : 0;
+            break;
+        case ND_MUL:
+            x = is_num(rhs, 1) ? node->lhs : is_num(lhs, 1) ? node->rhs : 0;
+            break;
+        default:
+            x = is_num(rhs, 1) ? node->lhs : 0;
+            break;
+    }
+    if (x && NODE(x)->ty == node->ty)
+        return x;
+    return id;
+}
+
+// 型を付けたばかりの式のノードを畳み込む
+void fold_expr(Node *node) {
+    switch (node->kind) {
+        case ND_ASSIGN:
+            node->rhs = simplify(node->rhs);
+            return;
+        case ND_DEREF:
+        case ND_RETURN:
+        case ND_EXPR_STMT:
+            node->lhs = simplify(node->lhs);
+            return;
+        case ND_ADD:
+        case ND_SUB:
+        case ND_MUL:
+        case ND_DIV:
+        case ND_EQ:
+        case ND_NE:
+        case ND_LT:
+        case ND_LE:
+            break;
+        default:
+            return;
+    }
+
+    node->lhs = simplify(node->lhs);
+    node->rhs = simplify(node->rhs);
+    Node *lhs = NODE(node->lhs);
+    Node *rhs = NODE(node->rhs);
+
+    long val;
+    if (lhs->kind == ND_NUM && rhs->kind == ND_NUM && eval(node->kind, lhs->val, rhs->val, &val)) {
+        node->kind = ND_NUM;
+        node->val = val; // valはlhsと重なっている
+        node->ty = int_type();
+        return;
+    }
+
+    if (node->kind == ND_MUL && ((is_num(rhs, 0) && is_pure(lhs)) || (is_num(lhs, 0) && is_pure(rhs)))) {
+        node->kind = ND_NUM;
+        node->val = 0;
+        node->ty = int_type();
+    }
+}
+
+// 条件が定数のif, while, forを畳み込み，代わりの文を返す．ほかの文はそのまま返す
+NodeId fold_stmt(NodeId id) {
+    Node *node = NODE(id);
+    if ((node->kind != ND_IF && node->kind != ND_WHILE && node->kind != ND_FOR) || !node->cond)
+        return id;
+    node->cond = simplify(node->cond);
+    Node *cond = NODE(node->cond);
+    if (cond->kind != ND_NUM)
+        return id;
+
+    switch (node->kind) {
+        case ND_IF:
+            if (cond->val)
+                return node->then;
+            if (node->els)
+                return node->els;
+            break;
+        case ND_WHILE:
+            if (cond->val) {
+                // 条件のないforと同じ無限ループにする．initとincは0のまま
+                node->kind = ND_FOR;
+                node->cond = 0;
+                return id;
+            }
+            break;
+        case ND_FOR:
+            if (cond->val) {
+                node->cond = 0;
+                return id;
+            }
+            // 初期化の式だけは実行する
+            if (node->init)
+                return node->init;
+            break;
+        default:
+            return id;
+    }
+
+    // 何もしない文にする
+    node->kind = ND_NULL;
+    return id;
+}
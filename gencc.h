@@ -1,11 +1,27 @@
+#define _DEFAULT_SOURCE
+
 #include<assert.h>
 #include<ctype.h>
+#include<dirent.h>
 #include<errno.h>
+#include<fcntl.h>
+#include<limits.h>
+#include<pthread.h>
+#include<setjmp.h>
+#include<signal.h>
+#include<stdatomic.h>
 #include<stdarg.h>
 #include<stdbool.h>
 #include<stdio.h>
 #include<stdlib.h>
 #include<string.h>
+#include<sys/mman.h>
+#include<sys/sendfile.h>
+#include<sys/socket.h>
+#include<sys/stat.h>
+#include<sys/un.h>
+#include<time.h>
+#include<unistd.h>
 
 typedef struct Token Token;
 typedef struct Var Var;
@@ -15,6 +31,35 @@ typedef struct Function Function;
 typedef struct Program Program;
 typedef struct Type Type;
 typedef struct Member Member;
+typedef struct Context Context;
+typedef struct Incremental Incremental;
+
+//
+// alloc.c
+//
+
+typedef struct ArenaChunk ArenaChunk;
+
+// バンプポインタ方式のメモリアリーナ
+// フェーズの終わりにまとめて解放する
+typedef struct {
+    char *name;         // 統計表示用の名前
+    ArenaChunk *chunks; // 確保したチャンクのリスト（先頭が使用中）
+    char *ptr;          // 次に割り当てる位置
+    char *end;          // 使用中のチャンクの終端
+
+    long nallocs;       // 割り当て回数
+    long nbytes;        // 割り当てたバイト数
+    long nchunks;       // 確保したチャンク数
+    long live;          // いま確保しているチャンクのバイト数
+    long peak;          // liveの最大値
+} Arena;
+
+void *arena_alloc(Arena *arena, long size);
+char *arena_strndup(Arena *arena, char *p, long len);
+void arena_release(Arena *arena);
+void arena_reset(Arena *arena);
+void print_alloc_stats(Arena *arena);
 
 //
 // tokenize.c
@@ -29,23 +74,38 @@ typedef enum {
     TK_EOF,      // 入力の終わりを表すトークン
 } TokenKind;
 
-// トークン型
+// トークン型．
+// 位置は入力の先頭からの32ビットのオフセットで持つ．綴りはTOK_STRで引く．
 struct Token {
     TokenKind kind; // トークンの型
+    unsigned loc;   // 入力の先頭からのオフセット
     Token *next;    // 次の入力トークン
-    long val;       // kindがTK_NUMの場合、その数値
-    char *str;      // トークン文字列
-    long len;       // トークンの長さ
-
-    char *contents; // 文字列リテラルの内容
-    long cont_len;  // 文字列リテラルの長さ
+    unsigned len;   // トークンの長さ
+    int cont_len;   // 文字列リテラルの長さ
+
+    union {
+        long val;       // kindがTK_NUMの場合、その数値
+        char *name;     // kindがTK_IDENTの場合，インターンした識別子
+        char *contents; // kindがTK_STRの場合，文字列リテラルの内容
+    };
 };
 
+// トークンの綴りの先頭
+#define TOK_STR(tok) (ctx->user_input + (tok)->loc)
+
+// 入力の大きさの上限．番兵の"\n\0"を足しても32ビットのオフセットに収まるようにする
+#define MAX_INPUT_SIZE ((1L << 32) - 2)
 
-void error(char *fmt, ...);
-void error_at(char *loc, char *fmt, ...);
-void error_tok(Token *tok, char *fmt, ...);
-char *strndup(char *p, long len);
+
+// エラーを報告する関数は，回復先か打ち切り先にlongjmpするかプロセスを終了し，戻ってこない
+__attribute__((noreturn)) void error(char *fmt, ...);
+__attribute__((noreturn)) void error_at(char *loc, char *fmt, ...);
+__attribute__((noreturn)) void error_tok(Token *tok, char *fmt, ...);
+__attribute__((noreturn)) void abort_compile(void);
+void print_error_summary(void);
+void set_max_errors(int n);
+void recover_errors(jmp_buf *env);
+void free_line_table(Context *c);
 Token *peek(char *op);
 Token *consume(char *op);
 Token *consume_ident();
@@ -54,11 +114,31 @@ long expect_number();
 char *expect_ident();
 bool at_eof();
 Token *new_token(TokenKind kind, Token *cur, char *str, long len);
+char *intern(char *p, long len);
 Token *tokenize();
+Token *tokenize_decl();
+void reset_intern_table();
+void free_intern_table();
+
+typedef struct InternEntry InternEntry;
 
-extern char *filename;
-extern char *user_input;
-extern Token *token;
+// 識別子のインターン表（開番地法）
+typedef struct {
+    InternEntry *entries;
+    long cap;
+    long used;
+} InternTable;
+
+//
+// scan.c
+//
+
+extern char *(*skip_space)(char *p);
+extern char *(*skip_ident)(char *p);
+extern char *(*skip_digit)(char *p);
+extern char *(*skip_line)(char *p);
+extern char *(*find_comment_end)(char *p);
+void init_scan();
 
 //
 // parse.c
@@ -72,6 +152,7 @@ struct Var {
 
     // ローカル変数の場合のみ
     long offset;    // RBPからのオフセット
+    int reg;        // 0でなければ，スタックの代わりに置く仮想レジスタ（mem2reg）
 
     // グローバル変数の場合のみ
     char *contents; // 文字列リテラルの内容
@@ -112,58 +193,114 @@ typedef enum {
     ND_NULL,        // 空文
 } NodeKind;
 
-// 抽象構文木のノード型
+// 抽象構文木のノードの番号．ノードはNodePoolの中に並べて置き，子は番号で指す．
+// 0はどのノードも指さない．
+typedef unsigned NodeId;
+
+// 抽象構文木のノード型．
+// 種類ごとに使うフィールドは決まっているので，共用体に重ねて置く．
 struct Node {
     NodeKind kind; // ノードの型
-    Node *next;    // 次のノード
+    NodeId next;   // 次のノード
     Type *ty;      // int or pointer to int
     Token *tok;    // トークン
 
-    Node *lhs;     // 左辺
-    Node *rhs;     // 右辺
-
-    // "if" or "while"
-    Node *cond;    // 条件
-    Node *then;    // condが真なら実行
-    Node *els;     // condが偽なら実行
-
-    // "for"
-    Node *init;    // 初期化
-    Node *inc;     //
-
-    // "block" or "stmt-expr"
-    Node *body;
-
-    // struct member access
-    char *member_name;
-    Member *member;
-
-    // function call
-    char *funcname;
-    Node *args;
-
-    long val;      // kindがND_NUMの場合のみ使う
-    Var *var;      // kindがND_LVARの場合のみ使う
+    union {
+        // 演算子, "return", 式文, struct member access
+        struct {
+            NodeId lhs;     // 左辺
+            NodeId rhs;     // 右辺
+            Member *member; // kindがND_MEMBERの場合のみ使う
+        };
+
+        // "if", "while", "for"
+        struct {
+            NodeId cond;    // 条件
+            NodeId then;    // condが真なら実行
+            union {
+                NodeId els; // condが偽なら実行
+                NodeId init;// "for"の初期化
+            };
+            NodeId inc;     // "for"の更新
+        };
+
+        // "block" or "stmt-expr"
+        NodeId body;
+
+        // function call
+        struct {
+            NodeId args;
+            char *funcname;
+        };
+
+        long val;      // kindがND_NUMの場合のみ使う
+        Var *var;      // kindがND_VARの場合のみ使う
+    };
 };
 
+// 1ブロックのノード数．ブロックは動かさないので，ノードへのポインタは
+// 次にreset_nodesを呼ぶまで使える．
+#define NODE_BLOCK_SHIFT 12
+#define NODE_BLOCK_MASK ((1 << NODE_BLOCK_SHIFT) - 1)
+
+// ノードを番号の順に並べて置く領域．
+// コードを生成した関数のノードはまとめて捨て，ブロックは次の関数で使い回す．
+typedef struct {
+    Node **blocks;
+    long nblocks;
+    NodeId len;     // 使っているノードの数（0番を含む）
+    long total;     // これまでに作ったノードの数
+    long peak;      // lenの最大値
+} NodePool;
+
+#define NODE(id) (&ctx->nodes.blocks[(id) >> NODE_BLOCK_SHIFT][(id) & NODE_BLOCK_MASK])
+
+typedef struct Binding Binding;
+typedef struct ScopeSlot ScopeSlot;
+
+// スコープ付きの変数表
+typedef struct {
+    ScopeSlot *slots;   // 名前で引くハッシュ表（開番地法）
+    long cap;
+    long used;
+
+    Binding **undo_log; // 登録した順の束縛．スコープを抜けるときに巻き戻す
+    long undo_len;
+    long undo_cap;
+} Scope;
+
 // 関数本体
 struct Function {
-    Function *next; // 次の関数
     char *name;     // 関数名
     VarList *params;// 関数の引数リスト
 
-    Node *node;     // 関数の構文木
+    NodeId node;    // 関数の構文木
     VarList *locals;// ローカル変数のリスト
     long stack_size;// ローカル変数で使用するスタックサイズ
+
+    VarList *strings;   // 関数の中の文字列リテラル（globalsの中の，新しい順のnstrings個）
+    long nstrings;
+
+    // 増分コンパイル
+    unsigned long fingerprint[2]; // 本体のトークン列と参照するグローバル変数のハッシュ
+    char *text;         // 関数のアセンブリ．前回のものを使うか，codegenが残す
+    long text_len;
+    bool text_reused;   // textが前回のコンパイル結果を指している
 };
 
-// プログラム本体
+// プログラム本体．関数は読むたびにコードを生成して捨てるので，残るのはグローバル変数だけ
 struct Program {
     VarList *global;    // グローバル変数
-    Function *fns;      // 関数のリスト
 };
 
-Program *program();
+Program *program(void (*emit_fn)(Function *fn, void *arg), void *arg);
+Var *push_var(char *name, Type *ty, bool is_local);
+char *new_label();
+Var *find_var(Token *tok);
+void reset_scope();
+void free_scope();
+void reset_nodes();
+void free_nodes();
 
 //
 // type.c
@@ -177,11 +314,18 @@ typedef enum {
     TY_STRUCT,
 } TypeKind;
 
+// 型．ポインタ型と配列型はpointer_to/array_ofで一意に作られるので，
+// ポインタの比較で同じ型かどうかがわかる．
 struct Type {
     TypeKind kind;
+    long size;          // sizeof()の値
     Type *base;         // pointer or array
     long array_size;    // array
     Member *members;    // struct
+
+    // struct: メンバ名で引くハッシュ表（開番地法）
+    Member **member_index;
+    long member_cap;
 };
 
 struct Member {
@@ -191,15 +335,349 @@ struct Member {
     long offset;
 };
 
+// ポインタ型・配列型の表（開番地法）
+typedef struct {
+    Type **types;
+    long cap;
+    long used;
+} TypeTable;
+
+Type *new_type(TypeKind kind);
 Type *char_type();
 Type *int_type();
 Type *pointer_to(Type *base);
 Type *array_of(Type *base, long size);
 long size_of(Type *ty);
-void add_type(Program *prog);
+void build_member_index(Type *ty);
+Member *find_member(Type *ty, char *name);
+void add_type(Node *node);
+void reset_type_table();
+void free_type_table();
+
+//
+// fold.c
+//
+
+NodeId simplify(NodeId id);
+void fold_expr(Node *node);
+NodeId fold_stmt(NodeId id);
+
+//
+// output.c
+//
+
+// 出力バッファ．追記していき，大きくなったらまとめてwriteする．
+typedef struct {
+    char *data;
+    long len;
+    long cap;
+    int fd;     // 書き出し先．負ならメモリに溜めるだけ
+} Buffer;
+
+Buffer *new_buffer(int fd);
+void free_buffer(Buffer *buf);
+void buf_flush(Buffer *buf);
+void buf_write(Buffer *buf, char *p, long len);
+bool buf_read(Buffer *buf, int fd, long len);
+bool buf_copy_file(Buffer *buf, int fd, long len);
+void buf_puts(Buffer *buf, char *s);
+void buf_putc(Buffer *buf, char c);
+void buf_putl(Buffer *buf, long val);
+void buf_vformat(Buffer *buf, char *fmt, va_list ap);
+void buf_format(Buffer *buf, char *fmt, ...);
+
+// 出力ファイル．同じディレクトリの一時ファイルに書き，成功したときだけ置き換える
+typedef struct {
+    char *path;
+    char *tmppath;  // 書き込み中の一時ファイル．NULLならpathに直接書いている
+    int fd;
+} OutFile;
+
+OutFile *open_output(char *path);
+bool close_output(OutFile *of, bool ok);
+
+//
+// pool.c
+//
+
+typedef struct ThreadPool ThreadPool;
+
+ThreadPool *new_pool(int nthreads);
+void free_pool(ThreadPool *pool);
+int pool_size(ThreadPool *pool);
+void pool_run(ThreadPool *pool, long njobs, void (*fn)(void *arg, long i), void *arg);
+
+//
+// ir.c
+//
+
+// 中間表現の命令．dは結果の仮想レジスタ，a, bは被演算子の仮想レジスタ
+typedef enum {
+    IR_IMM,         // d = imm
+    IR_MOV,         // d = a
+    IR_ADD,         // d = a + b
+    IR_SUB,         // d = a - b
+    IR_MUL,         // d = a * b
+    IR_DIV,         // d = a / b
+    IR_EQ,          // d = a == b
+    IR_NE,          // d = a != b
+    IR_LT,          // d = a < b
+    IR_LE,          // d = a <= b
+    IR_ADDR,        // d = &var
+    IR_LOAD,        // d = *a（sizeバイト）
+    IR_STORE,       // *a = b（sizeバイト）
+    IR_STORE_ARG,   // var = imm番目の引数レジスタ
+    IR_ARG,         // d = imm番目の引数レジスタ
+    IR_CALL,        // d = funcname(args...)
+    IR_JMP,         // goto bb1
+    IR_BR,          // a != 0 ? goto bb1 : goto bb2
+    IR_RET,         // aを返す．aが0なら値なし
+} IrOp;
+
+typedef struct Ir Ir;
+typedef struct BB BB;
+
+struct Ir {
+    IrOp op;
+    int d;
+    int a;
+    int b;
+    int size;       // IR_LOAD, IR_STORE
+    long imm;       // IR_IMM, IR_STORE_ARG, IR_ARG
+    Var *var;       // IR_ADDR, IR_STORE_ARG
+    char *funcname; // IR_CALL
+    int *args;      // IR_CALL
+    int nargs;
+    BB *bb1;        // IR_JMP, IR_BR
+    BB *bb2;        // IR_BR
+    Ir *next;
+};
+
+// 基本ブロック．最後の命令だけがIR_JMP, IR_BR, IR_RETのどれかである
+struct BB {
+    int label;      // 関数の中の通し番号
+    Ir *first;
+    Ir *last;
+    BB *next;       // 配置する順で次のブロック
+};
+
+// 1つの関数の中間表現
+typedef struct {
+    Function *fn;
+    Arena *arena;   // 命令とブロックの割り当て先
+    BB *bbs;        // 先頭のブロックが入口
+    BB *last;
+    int nbbs;
+    int nregs;      // 仮想レジスタは1からnregs-1まで
+    Var **reg_var;  // 変数を置いた仮想レジスタならその変数．このレジスタだけは何度でも定義できる
+
+    // レジスタ割り当ての結果
+    int *loc;       // 仮想レジスタごとに，0以上なら物理レジスタの番号，-1以下ならスピル領域の番号
+    int nspills;
+    unsigned used_regs; // 使った物理レジスタのビット集合
+} IrFunc;
+
+IrFunc *lower_function(Function *fn, Arena *arena);
+bool is_terminator(Ir *ir);
+int ir_uses(Ir *ir, int **regs);
+bool ir_defines(Ir *ir);
+int bb_succs(BB *bb, BB *succs[2]);
+void verify_ir(IrFunc *f);
+void dump_ir(IrFunc *f, Buffer *out);
+
+//
+// mem2reg.c
+//
+
+void mem2reg(IrFunc *f);
+
+//
+// peephole.c
+//
+
+// x86-64の汎用レジスタ
+typedef enum {
+    REG_RAX,
+    REG_RCX,
+    REG_RDX,
+    REG_RBX,
+    REG_RSP,
+    REG_RBP,
+    REG_RSI,
+    REG_RDI,
+    REG_R8,
+    REG_R9,
+    REG_R10,
+    REG_R11,
+    REG_R12,
+    REG_R13,
+    REG_R14,
+    REG_R15,
+} Reg;
+
+// 命令の被演算子の種類
+typedef enum {
+    OPD_NONE,
+    OPD_REG,    // レジスタのsizeバイトの部分
+    OPD_IMM,    // 即値val
+    OPD_MEM,    // [reg+val]のsizeバイト
+    OPD_SYM,    // 関数やグローバル変数の名前．movの右辺ならそのアドレス
+    OPD_LABEL,  // 関数の中のラベル．valがブロックの番号で，RETURN_LABELならエピローグ
+} OperandKind;
+
+#define RETURN_LABEL -1
+
+typedef struct {
+    OperandKind kind;
+    Reg reg;
+    int size;
+    long val;
+    char *sym;
+} Operand;
+
+typedef enum {
+    I_NOP,      // のぞき穴最適化で消した命令
+    I_LABEL,    // opd[0]のラベル
+    I_MOV,
+    I_MOVSX,
+    I_MOVZX,
+    I_LEA,
+    I_ADD,
+    I_SUB,
+    I_IMUL,
+    I_CQO,
+    I_IDIV,
+    I_CMP,
+    I_SET,      // setcc
+    I_JMP,
+    I_JCC,      // jcc
+    I_CALL,
+    I_PUSH,
+    I_POP,
+    I_RET,
+} InsnOp;
+
+typedef enum {
+    CC_E,
+    CC_NE,
+    CC_L,
+    CC_LE,
+    CC_G,
+    CC_GE,
+} CondCode;
+
+// 構造化したアセンブリの命令
+typedef struct {
+    InsnOp op;
+    CondCode cc;    // I_SET, I_JCC
+    Operand opd[2];
+} Insn;
+
+void peephole(Insn *insns, long n, int nlabels);
+void print_insns(Buffer *out, Insn *insns, long n, char *funcname);
+char *reg_name(Reg reg, int size);
+void set_peephole(char *spec);
+void print_peephole_stats();
+
+//
+// regalloc.c
+//
+
+// 割り当てに使う物理レジスタの数．先頭のNUM_CALLER_SAVED個は呼び出し元保存
+#define NUM_REGS 7
+#define NUM_CALLER_SAVED 2
+
+extern Reg phys_regs[NUM_REGS];
+
+void alloc_regs(IrFunc *f);
 
 //
 // codegen.c
 //
 
-void codegen(Program *prog);
+void enable_dump_ir();
+void codegen_begin(Buffer *buf);
+void codegen_functions(Function **fns, long nfns, Buffer *buf, ThreadPool *pool);
+void codegen_end(Program *prog, Buffer *buf);
+
+//
+// main.c
+//
+
+// 翻訳単位ごとの状態．
+// 複数のファイルを並列にコンパイルするので，ファイルごとに1つ作り，
+// コンパイルするスレッドのctxに設定する．
+struct Context {
+    char *filename;     // 入力ファイル名
+    char *user_input;   // 入力ファイルの内容
+    long input_maplen;  // user_inputをmmapした長さ．mallocした場合は0
+    char *input_pos;    // 次にトークナイズする位置
+    Token *token;       // 現在着目しているトークン
+    FILE *errout;       // 診断メッセージの出力先．NULLなら標準エラー出力
+    unsigned *line_starts; // 各行の先頭のオフセット．最初の診断メッセージで作る
+    long nlines;
+    int nerrors;        // 報告したエラーの数
+    jmp_buf *recover;   // エラーから回復して読み続ける位置．NULLなら打ち切る
+
+    // parse.c
+    Scope scope;        // いま見えている変数
+    VarList *locals;    // 現在の関数のローカル変数
+    VarList *globals;   // グローバル変数
+    int nlabels;        // 文字列リテラルのラベルの通し番号
+
+    // tokenize.c, type.c
+    InternTable intern;
+    TypeTable types;
+    NodePool nodes;     // 抽象構文木のノード
+    Incremental *inc;   // 増分コンパイルの前回の記録
+
+    // 各フェーズで使うアリーナ
+    // tok_arenaとfn_arenaは関数のコードを生成するたびに空にする
+    Arena tok_arena;    // Token
+    Arena fn_arena;     // ローカル変数, Function
+    Arena parse_arena;  // グローバル変数, 文字列リテラル, Member, Program
+    Arena type_arena;   // Type
+    Arena intern_arena; // インターンした識別子
+};
+
+extern _Thread_local Context *ctx;
+extern _Thread_local jmp_buf *bail;
+
+Context *new_context();
+void reset_context(Context *c);
+void free_context(Context *c);
+char *read_file(char *path, long *maplen);
+bool compile(Context *c, char *path, Buffer *out, ThreadPool *pool);
+char *asm_path(char *path);
+
+//
+// cache.c
+//
+
+void hash_bytes(unsigned long h[2], char *p, long len);
+void cache_init(char *dir, long max_size, char *flags);
+bool cache_enabled();
+void cache_key(char *p, long len, unsigned long key[2]);
+char *cache_entry_path(unsigned long key[2], char *suffix);
+bool cache_lookup(char *input, unsigned long key[2], Buffer *out);
+void cache_store(unsigned long key[2], char *suffix, char *data, long len);
+void print_cache_stats();
+
+//
+// incremental.c
+//
+
+void enable_incremental();
+void inc_begin(char *path);
+bool reuse_function(Function *fn);
+void inc_record(Function *fn);
+void inc_finish();
+void inc_release(Context *c);
+void print_inc_stats();
+
+//
+// server.c
+//
+
+void run_server(char *sockpath, int nthreads);
+int run_client(char *sockpath, char **files, long nfiles, char *outpath);
@@ -0,0 +1,303 @@
+#include "gencc.h"
+
+// 関数単位の増分コンパイル．
+//
+// 関数ごとに，本体のトークン列と，そこに現れる識別子が指すグローバル変数の型から
+// フィンガープリントを計算する．前回のコンパイルに同じフィンガープリントの関数があれば，
+// 本体をパースせずに読み飛ばし，保存しておいたアセンブリをそのまま使う．
+//
+// 文字列リテラルのラベルは翻訳単位の通し番号なので，関数の先頭での番号も
+// フィンガープリントに含める．読み飛ばした関数の文字列リテラルは記録から作り直すので，
+// データセクションも含めて出力は通常のコンパイルと同じになる．
+//
+// 翻訳単位ごとに，すべての関数の記録を1つのファイルにまとめてキャッシュに保存する．
+// ファイルの形式は次のとおり（数値はネイティブのlong）．
+//
+//   "GENCCFN1" 関数の数
+//   関数ごとに: フィンガープリント(2) 文字列の数 アセンブリの長さ
+//               (文字列の長さ 文字列)* アセンブリ
+
+#define MAGIC "GENCCFN1"
+
+typedef struct {
+    unsigned long fp[2];
+    long nstrings;
+    char *strings;      // (長さ 内容)*の並び
+    char *text;
+    long text_len;
+} IncEntry;
+
+struct Incremental {
+    unsigned long key[2];   // 記録のファイルのキー
+    char *data;             // 前回の記録（mmap）
+    long len;
+
+    IncEntry *entries;      // フィンガープリントで引くハッシュ表（開番地法）
+    long cap;
+    long nentries;
+
+    Buffer *out;            // 今回の記録
+    long nrecorded;         // 今回記録した関数の数
+    bool changed;           // 前回と違う関数があった
+};
+
+static bool enabled;
+static atomic_long fn_hits;
+static atomic_long fn_misses;
+
+// 増分コンパイルを有効にする．記録はキャッシュディレクトリに置く．
+void enable_incremental() {
+    if (!cache_enabled())
+        error("--incremental requires a cache directory");
+    enabled = true;
+}
+
+// 記録からlongを1つ読む．足りなければ偽を返す．
+static bool read_long(char **p, char *end, long *val) {
+    if (end - *p < (long)sizeof(long))
+        return false;
+    memcpy(val, *p, sizeof(long));
+    *p += sizeof(long);
+    return true;
+}
+
+static void add_entry(Incremental *inc, IncEntry *e) {
+    long i = e->fp[0] & (inc->cap - 1);
+    while (inc->entries[i].text)
+        i = (i + 1) & (inc->cap - 1);
+    inc->entries[i] = *e;
+}
+
+// 前回の記録を読んで表を作る．壊れていたら途中までの記録だけを使う．
+static void load_entries(Incremental *inc) {
+    char *p = inc->data;
+    char *end = inc->data + inc->len;
+    long n;
+    if (inc->len < 8 || memcmp(p, MAGIC, 8))
+        return;
+    p += 8;
+    if (!read_long(&p, end, &n) || n < 0 || n > inc->len)
+        return;
+
+    inc->cap = 16;
+    while (inc->cap < n * 2)
+        inc->cap *= 2;
+    inc->entries = calloc(inc->cap, sizeof(IncEntry));
+
+    for (long i = 0; i < n; i++) {
+        IncEntry e;
+        if (!read_long(&p, end, (long *)&e.fp[0]) || !read_long(&p, end, (long *)&e.fp[1]) ||
+            !read_long(&p, end, &e.nstrings) || !read_long(&p, end, &e.text_len))
+            return;
+
+        e.strings = p;
+        for (long j = 0; j < e.nstrings; j++) {
+            long len;
+            if (!read_long(&p, end, &len) || len < 0 || end - p < len)
+                return;
+            p += len;
+        }
+        if (e.text_len <= 0 || end - p < e.text_len)
+            return;
+        e.text = p;
+        p += e.text_len;
+        add_entry(inc, &e);
+        inc->nentries++;
+    }
+}
+
+// pathの前回の記録を読み込む．増分コンパイルが無効か，標準入力なら何もしない．
+void inc_begin(char *path) {
+    if (!enabled || !strcmp(path, "-"))
+        return;
+
+    // 同じファイルを別のディレクトリから指定しても同じ記録を使う
+    char *abs = realpath(path, NULL);
+    if (!abs)
+        return;
+    Incremental *inc = calloc(1, sizeof(Incremental));
+    ctx->inc = inc;
+    cache_key(abs, strlen(abs), inc->key);
+    free(abs);
+
+    char *file = cache_entry_path(inc->key, ".inc");
+    int fd = open(file, O_RDONLY);
+    free(file);
+    if (fd < 0)
+        return;
+
+    struct stat st;
+    if (!fstat(fd, &st) && st.st_size > 0) {
+        char *data = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data != MAP_FAILED) {
+            inc->data = data;
+            inc->len = st.st_size;
+            load_entries(inc);
+        }
+    }
+    close(fd);
+}
+
+// 型の構造をハッシュに混ぜる
+static void hash_type(unsigned long h[2], Type *ty) {
+    for (; ty; ty = ty->base) {
+        long desc[3] = { ty->kind, ty->size, ty->array_size };
+        hash_bytes(h, (char *)desc, sizeof(desc));
+
+        for (Member *mem = ty->members; mem; mem = mem->next) {
+            hash_bytes(h, mem->name, strlen(mem->name));
+            hash_bytes(h, (char *)&mem->offset, sizeof(mem->offset));
+            hash_type(h, mem->ty);
+        }
+    }
+}
+
+// いまのトークンから始まる関数の残り（引数と本体）のフィンガープリントを計算し，
+// 本体の直後のトークンを返す．本体が閉じていなければNULLを返す．
+static Token *fingerprint(Function *fn) {
+    unsigned long h[2] = { 0, 0 };
+    hash_bytes(h, fn->name, strlen(fn->name));
+    hash_bytes(h, (char *)&ctx->nlabels, sizeof(ctx->nlabels));
+
+    long depth = 0;
+    for (Token *tok = ctx->token; tok->kind != TK_EOF; tok = tok->next) {
+        hash_bytes(h, TOK_STR(tok), tok->len);
+
+        // 識別子がグローバル変数を指すなら，その型も混ぜる．
+        // 関数の先頭ではグローバル変数しか見えていないので，find_varで引ける．
+        // 実際にはローカル変数を指していても，余分に混ぜるだけで結果は変わらない．
+        if (tok->kind == TK_IDENT) {
+            Var *var = find_var(tok);
+            hash_bytes(h, var ? "G" : "-", 1);
+            if (var)
+                hash_type(h, var->ty);
+        }
+
+        if (tok->kind != TK_RESERVED || tok->len != 1)
+            continue;
+        if (*TOK_STR(tok) == '{')
+            depth++;
+        if (*TOK_STR(tok) == '}' && --depth == 0) {
+            fn->fingerprint[0] = h[0];
+            fn->fingerprint[1] = h[1];
+            return tok->next;
+        }
+    }
+    return NULL;
+}
+
+static IncEntry *find_entry(Incremental *inc, unsigned long fp[2]) {
+    if (!inc->cap)
+        return NULL;
+    long i = fp[0] & (inc->cap - 1);
+    for (;;) {
+        IncEntry *e = &inc->entries[i];
+        if (!e->text)
+            return NULL;
+        if (e->fp[0] == fp[0] && e->fp[1] == fp[1])
+            return e;
+        i = (i + 1) & (inc->cap - 1);
+    }
+}
+
+// 関数の本体が前回から変わっていなければ，読み飛ばして前回のアセンブリを設定する．
+// 引数リストの先頭のトークンで呼ぶ．
+bool reuse_function(Function *fn) {
+    Incremental *inc = ctx->inc;
+    if (!inc)
+        return false;
+
+    Token *end = fingerprint(fn);
+    IncEntry *e = end ? find_entry(inc, fn->fingerprint) : NULL;
+    if (!e) {
+        fn_misses++;
+        return false;
+    }
+    fn_hits++;
+
+    // 文字列リテラルを同じ順番で作り直すと，同じラベルになる
+    char *p = e->strings;
+    for (long i = 0; i < e->nstrings; i++) {
+        long len;
+        read_long(&p, p + sizeof(long), &len);
+        Var *var = push_var(new_label(), array_of(char_type(), len), false);
+        var->contents = p;
+        var->cont_len = len;
+        p += len;
+    }
+
+    fn->text = e->text;
+    fn->text_len = e->text_len;
+    fn->text_reused = true;
+    ctx->token = end;
+    return true;
+}
+
+// コードを生成した関数を今回の記録に加える．
+// codegenが残したアセンブリは記録に写したら解放する．
+void inc_record(Function *fn) {
+    Incremental *inc = ctx->inc;
+    if (!inc)
+        return;
+
+    if (!inc->out) {
+        inc->out = new_buffer(-1);
+        buf_write(inc->out, MAGIC, 8);
+        buf_write(inc->out, (char *)&inc->nrecorded, sizeof(long));
+    }
+    Buffer *buf = inc->out;
+    inc->nrecorded++;
+    inc->changed = inc->changed || !fn->text_reused;
+
+    buf_write(buf, (char *)fn->fingerprint, sizeof(fn->fingerprint));
+    buf_write(buf, (char *)&fn->nstrings, sizeof(long));
+    buf_write(buf, (char *)&fn->text_len, sizeof(long));
+
+    // stringsは新しい順なので，作った順に並べ直す
+    Var **strings = calloc(fn->nstrings + 1, sizeof(Var *));
+    VarList *vl = fn->strings;
+    for (long i = fn->nstrings - 1; i >= 0; i--, vl = vl->next)
+        strings[i] = vl->var;
+    for (long i = 0; i < fn->nstrings; i++) {
+        buf_write(buf, (char *)&strings[i]->cont_len, sizeof(long));
+        buf_write(buf, strings[i]->contents, strings[i]->cont_len);
+    }
+    free(strings);
+    buf_write(buf, fn->text, fn->text_len);
+
+    if (!fn->text_reused)
+        free(fn->text);
+    fn->text = NULL;
+}
+
+// 今回の記録を保存して，前回の記録を解放する．すべての関数のコードを生成した後に呼ぶ．
+void inc_finish() {
+    Incremental *inc = ctx->inc;
+    if (!inc)
+        return;
+
+    // すべて前回のままなら記録を書き直さない
+    if (inc->out && (inc->changed || inc->nrecorded != inc->nentries)) {
+        memcpy(inc->out->data + 8, &inc->nrecorded, sizeof(long));
+        cache_store(inc->key, ".inc", inc->out->data, inc->out->len);
+    }
+    inc_release(ctx);
+}
+
+void inc_release(Context *c) {
+    Incremental *inc = c->inc;
+    if (!inc)
+        return;
+    if (inc->data)
+        munmap(inc->data, inc->len);
+    if (inc->out)
+        free_buffer(inc->out);
+    free(inc->entries);
+    free(inc);
+    c->inc = NULL;
+}
+
+void print_inc_stats() {
+    fprintf(stderr, "incremental: %ld functions reused, %ld recompiled\n",
+            (long)fn_hits, (long)fn_misses);
+}
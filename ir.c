@@ -0,0 +1,703 @@
+#include "gencc.h"
+
+// 三番地コードの中間表現．
+//
+// 型付けの済んだ抽象構文木を，基本ブロックと仮想レジスタを使った命令列に下ろす．
+// 変数はすべてメモリに置き，IR_ADDRで得たアドレスにIR_LOAD, IR_STOREで読み書きする．
+// 式の値はそれぞれ新しい仮想レジスタに入れるので，どのレジスタも定義は1か所だけである．
+// ただし，mem2regが変数を置いたレジスタは代入のたびに定義される．
+//
+// 構文木はコード生成と同じく明示的なスタックで下りる．スタックマシンのpushとpopは
+// 仮想レジスタの番号を積むスタックに置き換わる．
+
+// いま下ろしている関数の状態．関数ごとに別のスレッドで下ろすので，スレッドごとに持つ
+static _Thread_local IrFunc *func;
+static _Thread_local BB *cur_bb;
+
+static BB *new_bb() {
+    BB *bb = arena_alloc(func->arena, sizeof(BB));
+    bb->label = func->nbbs++;
+    return bb;
+}
+
+// bbを配置してから，以降の命令をbbに追加する
+static void start_bb(BB *bb) {
+    if (func->last)
+        func->last->next = bb;
+    else
+        func->bbs = bb;
+    func->last = bb;
+    cur_bb = bb;
+}
+
+bool is_terminator(Ir *ir) {
+    return ir->op == IR_JMP || ir->op == IR_BR || ir->op == IR_RET;
+}
+
+static Ir *new_ir(IrOp op) {
+    // 終端命令の後ろの命令は，どこからも飛んでこない新しいブロックに入れる
+    if (!cur_bb)
+        start_bb(new_bb());
+
+    Ir *ir = arena_alloc(func->arena, sizeof(Ir));
+    ir->op = op;
+    if (cur_bb->last)
+        cur_bb->last->next = ir;
+    else
+        cur_bb->first = ir;
+    cur_bb->last = ir;
+
+    if (is_terminator(ir))
+        cur_bb = NULL;
+    return ir;
+}
+
+static int new_reg() {
+    return func->nregs++;
+}
+
+// 結果を持つ命令を追加して，結果のレジスタを返す
+static int emit_op(IrOp op, int a, int b) {
+    Ir *ir = new_ir(op);
+    ir->d = new_reg();
+    ir->a = a;
+    ir->b = b;
+    return ir->d;
+}
+
+static int emit_imm(long val) {
+    Ir *ir = new_ir(IR_IMM);
+    ir->d = new_reg();
+    ir->imm = val;
+    return ir->d;
+}
+
+static int emit_load(int addr, Type *ty) {
+    Ir *ir = new_ir(IR_LOAD);
+    ir->d = new_reg();
+    ir->a = addr;
+    ir->size = size_of(ty);
+    return ir->d;
+}
+
+// 構造体の値はアドレスで持つ．srcからdstへsizeバイトを8バイトずつ写し，端数は1バイトずつ写す
+static void emit_copy(int dst, int src, long size) {
+    for (long off = 0; off < size;) {
+        int width = size - off >= 8 ? 8 : 1;
+        int from = off ? emit_op(IR_ADD, src, emit_imm(off)) : src;
+        int to = off ? emit_op(IR_ADD, dst, emit_imm(off)) : dst;
+        Ir *ir = new_ir(IR_LOAD);
+        ir->d = new_reg();
+        ir->a = from;
+        ir->size = width;
+        Ir *st = new_ir(IR_STORE);
+        st->a = to;
+        st->b = ir->d;
+        st->size = width;
+        off += width;
+    }
+}
+
+static void emit_jmp(BB *bb) {
+    new_ir(IR_JMP)->bb1 = bb;
+}
+
+static void emit_br(int cond, BB *then, BB *els) {
+    Ir *ir = new_ir(IR_BR);
+    ir->a = cond;
+    ir->bb1 = then;
+    ir->bb2 = els;
+}
+
+//
+// 構文木から命令列への変換
+//
+
+typedef struct {
+    Node *node;
+    bool addr;      // 値ではなくアドレスを計算する
+    int state;      // 次に下ろす段
+    NodeId cur;     // 次に下ろすブロックの文や引数
+    int nargs;      // 下ろした引数の数
+    BB *bb[3];      // 制御構造の飛び先
+} Frame;
+
+static _Thread_local Frame *frames;
+static _Thread_local long nframes;
+static _Thread_local long frames_cap;
+
+// 式の値を持つ仮想レジスタのスタック
+static _Thread_local int *vals;
+static _Thread_local long nvals;
+static _Thread_local long vals_cap;
+
+// 子を下ろすフレームを積む．積むとframesが動くので，
+// 呼び出し元はこの後で自分のフレームに触れてはいけない．
+static void push_frame(Node *node, bool addr) {
+    if (nframes == frames_cap) {
+        frames_cap = frames_cap ? frames_cap * 2 : 64;
+        frames = realloc(frames, sizeof(Frame) * frames_cap);
+    }
+    frames[nframes++] = (Frame){ .node = node, .addr = addr };
+}
+
+static void lower_child(NodeId id) {
+    push_frame(NODE(id), false);
+}
+
+static void lower_addr_child(NodeId id) {
+    push_frame(NODE(id), true);
+}
+
+static void push_val(int reg) {
+    if (nvals == vals_cap) {
+        vals_cap = vals_cap ? vals_cap * 2 : 64;
+        vals = realloc(vals, sizeof(int) * vals_cap);
+    }
+    vals[nvals++] = reg;
+}
+
+static int pop_val() {
+    return vals[--nvals];
+}
+
+// アドレスを計算するフレームを1段進める．終わったら真を返す．
+static bool lower_addr_step(Frame *f, int state) {
+    Node *node = f->node;
+    switch (node->kind) {
+        case ND_VAR: {
+            Ir *ir = new_ir(IR_ADDR);
+            ir->d = new_reg();
+            ir->var = node->var;
+            push_val(ir->d);
+            return true;
+        }
+        case ND_DEREF:
+            if (state == 0) {
+                lower_child(node->lhs);
+                return false;
+            }
+            return true;
+        case ND_MEMBER:
+            if (state == 0) {
+                lower_addr_child(node->lhs);
+                return false;
+            }
+            int base = pop_val();
+            push_val(emit_op(IR_ADD, base, emit_imm(node->member->offset)));
+            return true;
+        default:
+            break;
+    }
+    error_tok(node->tok, "not a variable");
+}
+
+// 二項演算子のノードに対応する命令
+static IrOp binary_op(Node *node) {
+    switch (node->kind) {
+        case ND_ADD: return IR_ADD;
+        case ND_SUB: return IR_SUB;
+        case ND_MUL: return IR_MUL;
+        case ND_DIV: return IR_DIV;
+        case ND_EQ: return IR_EQ;
+        case ND_NE: return IR_NE;
+        case ND_LT: return IR_LT;
+        case ND_LE: return IR_LE;
+        default:
+            // unreachable
+            error_tok(node->tok, "invalid node");
+    }
+}
+
+// 値を計算するフレームを1段進める．終わったら真を返す．
+// 子のフレームを積んだら，その場で偽を返す．
+// 文は値を残さず，式は値のレジスタを1つvalsに積む．
+static bool lower_step(Frame *f, int state) {
+    Node *node = f->node;
+    switch (node->kind) {
+        case ND_NULL:
+            return true;
+        case ND_IF:
+            switch (state) {
+                case 0:
+                    lower_child(node->cond);
+                    return false;
+                case 1:
+                    f->bb[0] = new_bb();
+                    f->bb[1] = node->els ? new_bb() : NULL;
+                    f->bb[2] = new_bb();
+                    emit_br(pop_val(), f->bb[0], node->els ? f->bb[1] : f->bb[2]);
+                    start_bb(f->bb[0]);
+                    lower_child(node->then);
+                    return false;
+                case 2:
+                    emit_jmp(f->bb[2]);
+                    if (!node->els) {
+                        start_bb(f->bb[2]);
+                        return true;
+                    }
+                    start_bb(f->bb[1]);
+                    lower_child(node->els);
+                    return false;
+                default:
+                    emit_jmp(f->bb[2]);
+                    start_bb(f->bb[2]);
+                    return true;
+            }
+        case ND_WHILE:
+            switch (state) {
+                case 0:
+                    f->bb[0] = new_bb();
+                    f->bb[2] = new_bb();
+                    emit_jmp(f->bb[0]);
+                    start_bb(f->bb[0]);
+                    lower_child(node->cond);
+                    return false;
+                case 1:
+                    f->bb[1] = new_bb();
+                    emit_br(pop_val(), f->bb[1], f->bb[2]);
+                    start_bb(f->bb[1]);
+                    lower_child(node->then);
+                    return false;
+                default:
+                    emit_jmp(f->bb[0]);
+                    start_bb(f->bb[2]);
+                    return true;
+            }
+        case ND_FOR:
+            // 省略された部分は何も積まずに次の段へ進む
+            switch (state) {
+                case 0:
+                    f->bb[0] = new_bb();
+                    f->bb[2] = new_bb();
+                    if (node->init)
+                        lower_child(node->init);
+                    return false;
+                case 1:
+                    emit_jmp(f->bb[0]);
+                    start_bb(f->bb[0]);
+                    if (node->cond)
+                        lower_child(node->cond);
+                    return false;
+                case 2:
+                    if (node->cond) {
+                        f->bb[1] = new_bb();
+                        emit_br(pop_val(), f->bb[1], f->bb[2]);
+                        start_bb(f->bb[1]);
+                    }
+                    lower_child(node->then);
+                    return false;
+                case 3:
+                    if (node->inc)
+                        lower_child(node->inc);
+                    return false;
+                default:
+                    emit_jmp(f->bb[0]);
+                    start_bb(f->bb[2]);
+                    return true;
+            }
+        case ND_FUNCALL: {
+            if (state == 0)
+                f->cur = node->args;
+            if (f->cur) {
+                NodeId arg = f->cur;
+                f->cur = NODE(arg)->next;
+                f->nargs++;
+                f->state = 1; // 引数がなくなるまでこの段を繰り返す
+                lower_child(arg);
+                return false;
+            }
+
+            Ir *ir = new_ir(IR_CALL);
+            ir->funcname = node->funcname;
+            ir->nargs = f->nargs;
+            ir->args = arena_alloc(func->arena, sizeof(int) * f->nargs);
+            for (int i = f->nargs - 1; i >= 0; i--)
+                ir->args[i] = pop_val();
+            ir->d = new_reg();
+            push_val(ir->d);
+            return true;
+        }
+        case ND_EXPR_STMT:
+            if (state == 0) {
+                lower_child(node->lhs);
+                return false;
+            }
+            pop_val(); // 使わない値を捨てる
+            return true;
+        case ND_BLOCK:
+        case ND_STMT_EXPR: {
+            if (state == 0)
+                f->cur = node->body;
+            if (!f->cur)
+                return true;
+            NodeId stmt = f->cur;
+            f->cur = NODE(stmt)->next;
+            f->state = 1; // 文がなくなるまでこの段を繰り返す
+            lower_child(stmt);
+            return false;
+        }
+        case ND_RETURN:
+            if (state == 0) {
+                lower_child(node->lhs);
+                return false;
+            }
+            new_ir(IR_RET)->a = pop_val();
+            return true;
+        case ND_ADDR:
+            if (state == 0) {
+                lower_addr_child(node->lhs);
+                return false;
+            }
+            return true;
+        case ND_DEREF:
+            if (state == 0) {
+                lower_child(node->lhs);
+                return false;
+            }
+            if (node->ty->kind != TY_ARRAY && node->ty->kind != TY_STRUCT)
+                push_val(emit_load(pop_val(), node->ty));
+            return true;
+        case ND_NUM:
+            push_val(emit_imm(node->val));
+            return true;
+        case ND_VAR:
+        case ND_MEMBER:
+            if (state == 0) {
+                push_frame(node, true);
+                return false;
+            }
+            if (node->ty->kind != TY_ARRAY && node->ty->kind != TY_STRUCT)
+                push_val(emit_load(pop_val(), node->ty));
+            return true;
+        case ND_ASSIGN:
+            if (state == 0) {
+                Node *lhs = NODE(node->lhs);
+                if (lhs->ty->kind == TY_ARRAY)
+                    error_tok(lhs->tok, "not an lvalue");
+                push_frame(lhs, true);
+                return false;
+            }
+            if (state == 1) {
+                lower_child(node->rhs);
+                return false;
+            }
+            // 代入式の値は代入した値．構造体は左辺のアドレスを値にする
+            int val = pop_val();
+            if (node->ty->kind == TY_STRUCT) {
+                int addr = pop_val();
+                emit_copy(addr, val, size_of(node->ty));
+                push_val(addr);
+                return true;
+            }
+            Ir *ir = new_ir(IR_STORE);
+            ir->a = pop_val();
+            ir->b = val;
+            ir->size = size_of(node->ty);
+            push_val(val);
+            return true;
+        default:
+            break;
+    }
+
+    // 二項演算子
+    if (state == 0) {
+        lower_child(node->lhs);
+        return false;
+    }
+    if (state == 1) {
+        lower_child(node->rhs);
+        return false;
+    }
+
+    int rhs = pop_val();
+    int lhs = pop_val();
+    if ((node->kind == ND_ADD || node->kind == ND_SUB) && node->ty->base)
+        rhs = emit_op(IR_MUL, rhs, emit_imm(size_of(node->ty->base))); // ptr + x => (ptr + x*8)
+    push_val(emit_op(binary_op(node), lhs, rhs));
+    return true;
+}
+
+static void lower(Node *node) {
+    long base = nframes;
+    push_frame(node, false);
+
+    while (nframes > base) {
+        // 段を進める前にstateを増やしておくので，子を積んで戻ってきたら次の段から続く
+        long i = nframes - 1;
+        Frame *f = &frames[i];
+        int state = f->state++;
+        bool done = f->addr ? lower_addr_step(f, state) : lower_step(f, state);
+        if (done)
+            nframes = i; // 子を積んでいないので，一番上はまだこのフレーム
+    }
+}
+
+// 関数を中間表現に下ろす．命令とブロックはarenaから割り当てる．
+IrFunc *lower_function(Function *fn, Arena *arena) {
+    func = arena_alloc(arena, sizeof(IrFunc));
+    func->fn = fn;
+    func->arena = arena;
+    func->nregs = 1;
+    nframes = 0;
+    nvals = 0;
+    start_bb(new_bb());
+
+    // 引数をレジスタからスタックに移す
+    int i = 0;
+    for (VarList *vl = fn->params; vl; vl = vl->next) {
+        Ir *ir = new_ir(IR_STORE_ARG);
+        ir->var = vl->var;
+        ir->imm = i++;
+    }
+
+    for (NodeId n = fn->node; n; n = NODE(n)->next)
+        lower(NODE(n));
+
+    // returnせずに終わったときは，値なしで返る
+    if (cur_bb)
+        new_ir(IR_RET);
+
+    IrFunc *f = func;
+    func = NULL;
+    return f;
+}
+
+//
+// 検査
+//
+// 変換や最適化の誤りを早く見つけるために，中間表現が満たすべき条件を調べる．
+// 誤りはコンパイラ自身の不具合なので，見つけたら打ち切る．
+//
+
+static void ir_error(IrFunc *f, BB *bb, char *msg) {
+    error("%s: bb%d: invalid IR: %s", f->fn->name, bb->label, msg);
+}
+
+static bool valid_reg(IrFunc *f, int r) {
+    return 0 < r && r < f->nregs;
+}
+
+// 変数を置いたレジスタは何度でも定義でき，初期化せずに読んでもよい
+static bool is_var_reg(IrFunc *f, int r) {
+    return f->reg_var && f->reg_var[r];
+}
+
+// 命令が読むレジスタをregsに書き出して，その数を返す
+int ir_uses(Ir *ir, int **regs) {
+    static _Thread_local int buf[2];
+    switch (ir->op) {
+        case IR_MOV:
+        case IR_LOAD:
+        case IR_BR:
+            buf[0] = ir->a;
+            *regs = buf;
+            return 1;
+        case IR_RET:
+            buf[0] = ir->a;
+            *regs = buf;
+            return ir->a ? 1 : 0;
+        case IR_ADD:
+        case IR_SUB:
+        case IR_MUL:
+        case IR_DIV:
+        case IR_EQ:
+        case IR_NE:
+        case IR_LT:
+        case IR_LE:
+        case IR_STORE:
+            buf[0] = ir->a;
+            buf[1] = ir->b;
+            *regs = buf;
+            return 2;
+        case IR_CALL:
+            *regs = ir->args;
+            return ir->nargs;
+        default:
+            return 0;
+    }
+}
+
+bool ir_defines(Ir *ir) {
+    switch (ir->op) {
+        case IR_STORE:
+        case IR_STORE_ARG:
+        case IR_JMP:
+        case IR_BR:
+        case IR_RET:
+            return false;
+        default:
+            return true;
+    }
+}
+
+// ブロックの飛び先をsuccsに書き出して，その数を返す
+int bb_succs(BB *bb, BB *succs[2]) {
+    Ir *ir = bb->last;
+    succs[0] = ir->bb1;
+    succs[1] = ir->bb2;
+    return ir->op == IR_JMP ? 1 : ir->op == IR_BR ? 2 : 0;
+}
+
+void verify_ir(IrFunc *f) {
+    // ブロックの番号から引く表．飛び先がこの関数のブロックかを調べる
+    BB **bbs = calloc(f->nbbs, sizeof(BB *));
+    long n = 0;
+    for (BB *bb = f->bbs; bb; bb = bb->next, n++) {
+        if (bb->label < 0 || bb->label >= f->nbbs || bbs[bb->label])
+            ir_error(f, bb, "bad block label");
+        bbs[bb->label] = bb;
+    }
+    if (n != f->nbbs)
+        error("%s: invalid IR: %ld blocks, expected %d", f->fn->name, n, f->nbbs);
+
+    // 各レジスタを定義したブロックと，命令の通し番号での位置．
+    // 同じブロックの中では定義より前で使っていないかも調べる
+    BB **def_bb = calloc(f->nregs, sizeof(BB *));
+    long *def_pos = calloc(f->nregs, sizeof(long));
+    long pos = 0;
+    for (BB *bb = f->bbs; bb; bb = bb->next) {
+        if (!bb->first)
+            ir_error(f, bb, "empty block");
+        for (Ir *ir = bb->first; ir; ir = ir->next, pos++) {
+            if (is_terminator(ir) != (ir == bb->last))
+                ir_error(f, bb, "terminator must end the block");
+            if ((ir->op == IR_LOAD || ir->op == IR_STORE) && ir->size != 1 && ir->size != 8)
+                ir_error(f, bb, "bad access size");
+            if ((ir->op == IR_ADDR || ir->op == IR_STORE_ARG) && !ir->var)
+                ir_error(f, bb, "missing variable");
+
+            BB *targets[2] = { ir->bb1, ir->bb2 };
+            int ntargets = ir->op == IR_JMP ? 1 : ir->op == IR_BR ? 2 : 0;
+            for (int i = 0; i < ntargets; i++) {
+                BB *t = targets[i];
+                if (!t || t->label < 0 || t->label >= f->nbbs || bbs[t->label] != t)
+                    ir_error(f, bb, "branch to a block outside the function");
+            }
+
+            if (ir_defines(ir)) {
+                if (!valid_reg(f, ir->d))
+                    ir_error(f, bb, "bad destination register");
+                if (def_bb[ir->d] && !is_var_reg(f, ir->d))
+                    ir_error(f, bb, "register defined twice");
+                def_bb[ir->d] = bb;
+                def_pos[ir->d] = pos;
+            }
+        }
+    }
+
+    pos = 0;
+    for (BB *bb = f->bbs; bb; bb = bb->next) {
+        for (Ir *ir = bb->first; ir; ir = ir->next, pos++) {
+            int *regs;
+            int nuses = ir_uses(ir, &regs);
+            for (int i = 0; i < nuses; i++) {
+                int r = regs[i];
+                if (valid_reg(f, r) && is_var_reg(f, r))
+                    continue;
+                if (!valid_reg(f, r) || !def_bb[r])
+                    ir_error(f, bb, "use of an undefined register");
+                if (def_bb[r] == bb && def_pos[r] >= pos)
+                    ir_error(f, bb, "register used before its definition");
+            }
+        }
+    }
+
+    free(bbs);
+    free(def_bb);
+    free(def_pos);
+}
+
+//
+// 表示
+//
+
+static char *ir_names[] = {
+    [IR_IMM] = "imm",
+    [IR_MOV] = "mov",
+    [IR_ADD] = "add",
+    [IR_SUB] = "sub",
+    [IR_MUL] = "mul",
+    [IR_DIV] = "div",
+    [IR_EQ] = "eq",
+    [IR_NE] = "ne",
+    [IR_LT] = "lt",
+    [IR_LE] = "le",
+    [IR_ADDR] = "addr",
+    [IR_LOAD] = "load",
+    [IR_STORE] = "store",
+    [IR_STORE_ARG] = "store_arg",
+    [IR_ARG] = "arg",
+    [IR_CALL] = "call",
+    [IR_JMP] = "jmp",
+    [IR_BR] = "br",
+    [IR_RET] = "ret",
+};
+
+// 中間表現をアセンブリのコメントとして書き出す
+void dump_ir(IrFunc *f, Buffer *out) {
+    buf_format(out, "# %s: %d blocks, %d registers\n", f->fn->name, f->nbbs, f->nregs - 1);
+    for (int r = 1; f->reg_var && r < f->nregs; r++)
+        if (f->reg_var[r])
+            buf_format(out, "# r%d: %s\n", r, f->reg_var[r]->name);
+
+    for (BB *bb = f->bbs; bb; bb = bb->next) {
+        buf_format(out, "# bb%d:\n", bb->label);
+        for (Ir *ir = bb->first; ir; ir = ir->next) {
+            buf_puts(out, "#   ");
+            if (ir_defines(ir))
+                buf_format(out, "r%d = ", ir->d);
+            buf_puts(out, ir_names[ir->op]);
+
+            switch (ir->op) {
+                case IR_IMM:
+                case IR_ARG:
+                    buf_format(out, " %ld", ir->imm);
+                    break;
+                case IR_ADDR:
+                    buf_format(out, " %s", ir->var->name);
+                    break;
+                case IR_LOAD:
+                    buf_format(out, "%d r%d", ir->size, ir->a);
+                    break;
+                case IR_STORE:
+                    buf_format(out, "%d r%d, r%d", ir->size, ir->a, ir->b);
+                    break;
+                case IR_STORE_ARG:
+                    buf_format(out, " %s, %ld", ir->var->name, ir->imm);
+                    break;
+                case IR_CALL:
+                    buf_format(out, " %s(", ir->funcname);
+                    for (int i = 0; i < ir->nargs; i++)
+                        buf_format(out, i ? ", r%d" : "r%d", ir->args[i]);
+                    buf_putc(out, ')');
+                    break;
+                case IR_JMP:
+                    buf_format(out, " bb%d", ir->bb1->label);
+                    break;
+                case IR_BR:
+                    buf_format(out, " r%d, bb%d, bb%d", ir->a, ir->bb1->label, ir->bb2->label);
+                    break;
+                case IR_RET:
+                    if (ir->a)
+                        buf_format(out, " r%d", ir->a);
+                    break;
+                case IR_MOV:
+                    buf_format(out, " r%d", ir->a);
+                    break;
+                default:
+                    buf_format(out, " r%d, r%d", ir->a, ir->b);
+                    break;
+            }
+
+            // レジスタを割り当てた後なら，結果の置き場所も表示する
+            if (f->loc && ir_defines(ir)) {
+                if (f->loc[ir->d] >= 0)
+                    buf_format(out, "  ; %s", reg_name(phys_regs[f->loc[ir->d]], 8));
+                else
+                    buf_format(out, "  ; spill%d", -f->loc[ir->d]);
+            }
+            buf_putc(out, '\n');
+        }
+    }
+}
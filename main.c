@@ -1,46 +1,644 @@
 #include "gencc.h"
 
-// ファイルの内容を読み込んで返す
-char *read_file(char *path) {
-    FILE *fp = fopen(path, "r");
-    if (!fp)
-        error("cannot open %s: %s", path, strerror(errno));
+// パイプなどサイズのわからない入力を，伸長可能なバッファに読み込む．
+// 失敗したらバッファを解放し，errnoを設定してNULLを返す．
+static char *read_stream(int fd) {
+    long cap = 64 * 1024;
+    long size = 0;
+    char *buf = malloc(cap);
+    if (!buf)
+        return NULL;
+
+    for (;;) {
+        // 番兵の"\n\0"のために2バイト残しておく
+        if (cap - size < 2 + 4096) {
+            char *p = realloc(buf, cap * 2);
+            if (!p)
+                goto fail;
+            buf = p;
+            cap *= 2;
+        }
 
-    int filemax = 10 * 1024 * 1024;
-    char *buf = malloc(filemax);
-    int size = fread(buf, 1, filemax - 2, fp);
-    if (!feof(fp))
-        error("%s: file too large");
+        ssize_t n = read(fd, buf + size, cap - size - 2);
+        if (n < 0) {
+            if (errno == EINTR)
+                continue;
+            goto fail;
+        }
+        if (n == 0)
+            break;
+        size += n;
+        if (size > MAX_INPUT_SIZE) {
+            errno = EFBIG;
+            goto fail;
+        }
+    }
 
     if (size == 0 || buf[size - 1] != '\n')
         buf[size++] = '\n';
     buf[size] = '\0';
     return buf;
+
+fail:;
+    int err = errno;
+    free(buf);
+    errno = err;
+    return NULL;
+}
+
+// 通常のファイルを読み取り専用でメモリにマップする．
+// ファイルの直後に"\n\0"が続くことを保証する．
+// 失敗したら領域を解放し，errnoを設定してNULLを返す．
+static char *map_file(int fd, long size, long maplen) {
+    long pagesize = sysconf(_SC_PAGESIZE);
+
+    // 番兵の分も含めて匿名ページで領域を予約し，その先頭にファイルを重ねる．
+    // ファイル末尾より後ろはゼロで埋まっているので，'\0'は書かなくてよい．
+    char *buf = mmap(NULL, maplen, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (buf == MAP_FAILED)
+        return NULL;
+    if (mmap(buf, size, PROT_READ, MAP_PRIVATE | MAP_FIXED, fd, 0) == MAP_FAILED)
+        goto fail;
+
+    // 末尾に改行がなければ，そのページだけ書き込み可能にして補う．
+    // MAP_PRIVATEなので元のファイルは変更されない．
+    if (buf[size - 1] != '\n') {
+        char *page = buf + (size & ~(pagesize - 1));
+        if (mprotect(page, pagesize, PROT_READ | PROT_WRITE))
+            goto fail;
+        buf[size] = '\n';
+    }
+    return buf;
+
+fail:;
+    int err = errno;
+    munmap(buf, maplen);
+    errno = err;
+    return NULL;
+}
+
+// ファイルの内容を読み込んで返す．
+// pathが"-"の場合は標準入力から読み込む．
+// mmapした場合はその長さを，mallocした場合は0を*maplenに設定する．
+// エラーはファイルを閉じてから報告するので，サーバで失敗してもファイルが漏れない．
+char *read_file(char *path, long *maplen) {
+    *maplen = 0;
+    char *buf;
+    char *op = "read";
+    if (!strcmp(path, "-")) {
+        buf = read_stream(STDIN_FILENO);
+        if (!buf)
+            goto fail;
+        return buf;
+    }
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
+        error("cannot open %s: %s", path, strerror(errno));
+
+    struct stat st;
+    if (fstat(fd, &st)) {
+        int err = errno;
+        close(fd);
+        error("cannot stat %s: %s", path, strerror(err));
+    }
+
+    if (st.st_size > MAX_INPUT_SIZE) {
+        close(fd);
+        error("%s: file too large", path);
+    }
+
+    long len = 0;
+    if (S_ISREG(st.st_mode) && st.st_size > 0) {
+        long pagesize = sysconf(_SC_PAGESIZE);
+        len = (st.st_size + 2 + pagesize - 1) & ~(pagesize - 1);
+        buf = map_file(fd, st.st_size, len);
+        op = "map";
+    } else {
+        buf = read_stream(fd);
+    }
+
+    int err = errno;
+    close(fd);
+    errno = err;
+    if (!buf)
+        goto fail;
+    *maplen = len;
+    return buf;
+
+fail:
+    if (errno == EFBIG)
+        error("%s: file too large", path);
+    if (errno == ENOMEM)
+        error("%s: out of memory", path);
+    error("cannot %s %s: %s", op, path, strerror(errno));
+}
+
+// 現在のスレッドでコンパイル中の翻訳単位
+_Thread_local Context *ctx;
+
+// エラーを報告したときの戻り先．NULLならプロセスを終了する．
+_Thread_local jmp_buf *bail;
+
+Context *new_context() {
+    Context *c = calloc(1, sizeof(Context));
+    c->tok_arena.name = "tokenize";
+    c->fn_arena.name = "function";
+    c->parse_arena.name = "parse";
+    c->type_arena.name = "type";
+    c->intern_arena.name = "intern";
+    return c;
+}
+
+// 入力ファイルを解放する
+static void release_input(Context *c) {
+    if (c->input_maplen)
+        munmap(c->user_input, c->input_maplen);
+    else
+        free(c->user_input);
+    c->user_input = NULL;
+    c->input_maplen = 0;
+    free_line_table(c);
+}
+
+// 次の翻訳単位をコンパイルできるようにcを空にする．
+// アリーナのチャンクや表の領域は解放せずに使い回す．
+void reset_context(Context *c) {
+    Context *saved = ctx;
+    ctx = c;
+    reset_intern_table();
+    reset_scope();
+    reset_type_table();
+    reset_nodes();
+    ctx = saved;
+
+    arena_reset(&c->tok_arena);
+    arena_reset(&c->fn_arena);
+    arena_reset(&c->parse_arena);
+    arena_reset(&c->type_arena);
+    arena_reset(&c->intern_arena);
+
+    inc_release(c);
+    release_input(c);
+    c->filename = NULL;
+    c->input_pos = NULL;
+    c->token = NULL;
+    c->errout = NULL;
+    c->nerrors = 0;
+    c->recover = NULL;
+    c->locals = NULL;
+    c->globals = NULL;
+    c->nlabels = 0;
+}
+
+// 翻訳単位のオブジェクトをまとめて解放する
+void free_context(Context *c) {
+    Context *saved = ctx;
+    ctx = c;
+    free_intern_table();
+    free_scope();
+    free_type_table();
+    free_nodes();
+    ctx = saved;
+
+    inc_release(c);
+    arena_release(&c->tok_arena);
+    arena_release(&c->fn_arena);
+    arena_release(&c->parse_arena);
+    arena_release(&c->type_arena);
+    arena_release(&c->intern_arena);
+    release_input(c);
+    free(c);
+}
+
+// トークナイザのマイクロベンチマーク．
+// 入力を1秒以上繰り返しトークナイズして，その速度を表示する．
+static void bench_tokenize() {
+    long len = strlen(ctx->user_input);
+    long ntokens = 0;
+    long iters = 0;
+    double elapsed;
+
+    struct timespec start, now;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    do {
+        for (Token *tok = tokenize(); tok; tok = tok->next)
+            ntokens++;
+        arena_release(&ctx->tok_arena);
+        free_intern_table();
+        arena_release(&ctx->intern_arena);
+        iters++;
+
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        elapsed = (now.tv_sec - start.tv_sec) + (now.tv_nsec - start.tv_nsec) / 1e9;
+    } while (elapsed < 1.0);
+
+    fprintf(stderr, "%ld iterations, %ld tokens in %.3f s\n", iters, ntokens, elapsed);
+    fprintf(stderr, "%.0f tokens/s, %.1f MB/s\n",
+            ntokens / elapsed, len * iters / elapsed / (1024 * 1024));
+}
+
+// コードを生成していない関数
+typedef struct {
+    Buffer *out;
+    ThreadPool *pool;
+    Function **fns;
+    long nfns;
+    long cap;   // これだけ溜まったらまとめて生成する
+} Stream;
+
+// 溜まった関数のコードを生成して，関数とトークンを解放する
+static void flush_functions(Stream *st) {
+    codegen_functions(st->fns, st->nfns, st->out, st->pool);
+    for (long i = 0; i < st->nfns; i++)
+        inc_record(st->fns[i]);
+    st->nfns = 0;
+    reset_nodes();
+    arena_reset(&ctx->fn_arena);
+    arena_reset(&ctx->tok_arena);
+}
+
+// programから関数を読むたびに呼ばれる．
+// スレッドプールで並列に生成できるように，スレッド数に応じた数だけ溜めてから生成する．
+static void stream_function(Function *fn, void *arg) {
+    Stream *st = arg;
+    st->fns[st->nfns++] = fn;
+    if (st->nfns == st->cap)
+        flush_functions(st);
+}
+
+// pathのファイルをコンパイルしてoutに書き出す．
+// c->user_inputが設定済みならファイルは読まずにそれを使う．
+// エラーがあればメッセージを表示してfalseを返す．
+// キャッシュが有効なら，同じ入力の結果があればそれを返し，なければ結果を保存する．
+bool compile(Context *c, char *path, Buffer *out, ThreadPool *pool) {
+    // キャッシュに保存する分はいったんメモリに溜める
+    Buffer *result = cache_enabled() ? new_buffer(-1) : NULL;
+
+    jmp_buf env;
+    ctx = c;
+    bail = &env;
+    if (setjmp(env)) {
+        bail = NULL;
+        print_error_summary();
+        if (result)
+            free_buffer(result);
+        inc_release(c);
+        return false;
+    }
+
+    if (!c->user_input)
+        c->user_input = read_file(path, &c->input_maplen);
+
+    unsigned long key[2];
+    if (result && cache_lookup(c->user_input, key, out)) {
+        free_buffer(result);
+        bail = NULL;
+        return true;
+    }
+
+    Buffer *dst = result ? result : out;
+    Stream st = {};
+    st.out = dst;
+    st.pool = pool;
+    st.cap = pool && pool_size(pool) > 1 ? pool_size(pool) * 4 : 1;
+    st.fns = arena_alloc(&c->parse_arena, sizeof(Function *) * st.cap);
+
+    // 関数を読むたびにコードを生成し，最後にグローバル変数を出力する
+    inc_begin(path);
+    codegen_begin(dst);
+    Program *prog = program(stream_function, &st);
+    flush_functions(&st);
+    codegen_end(prog, dst);
+
+    if (result) {
+        cache_store(key, ".s", result->data, result->len);
+        buf_write(out, result->data, result->len);
+        free_buffer(result);
+    }
+    inc_finish();
+    bail = NULL;
+    return true;
+}
+
+static void print_context_stats(Context *c) {
+    fprintf(stderr, "%s:\n", c->filename);
+    print_alloc_stats(&c->tok_arena);
+    print_alloc_stats(&c->fn_arena);
+    print_alloc_stats(&c->parse_arena);
+    print_alloc_stats(&c->type_arena);
+    print_alloc_stats(&c->intern_arena);
+
+    // ノードは数と1つあたりの大きさも表示する
+    NodePool *nodes = &c->nodes;
+    fprintf(stderr, "%-10s %10ld nodes  %12ld bytes %6ld blocks %12ld peak (%ld bytes/node)\n",
+            "node", nodes->total, nodes->total * (long)sizeof(Node), nodes->nblocks,
+            nodes->peak * (long)sizeof(Node), (long)sizeof(Node));
+}
+
+typedef struct {
+    char **files;
+    long nfiles;
+} FileList;
+
+static void add_file(FileList *list, char *path) {
+    if ((list->nfiles & (list->nfiles - 1)) == 0)
+        list->files = realloc(list->files, sizeof(char *) * (list->nfiles ? list->nfiles * 2 : 1));
+    list->files[list->nfiles++] = path;
+}
+
+// @fileの内容を空白区切りの引数として展開する．
+// 展開した引数の中の@fileも再帰的に展開する．
+static void read_response_file(FileList *list, char *path, int depth) {
+    if (depth > 16)
+        error("%s: response files nested too deeply", path);
+
+    long maplen;
+    char *buf = read_file(path, &maplen);
+    char *p = buf;
+    for (;;) {
+        while (isspace(*p))
+            p++;
+        if (!*p)
+            break;
+        char *q = p;
+        while (*q && !isspace(*q))
+            q++;
+        char *arg = strndup(p, q - p);
+        if (arg[0] == '@')
+            read_response_file(list, arg + 1, depth + 1);
+        else
+            add_file(list, arg);
+        p = q;
+    }
+
+    // 引数は複製してあるので，ファイルの内容はもう使わない
+    if (maplen)
+        munmap(buf, maplen);
+    else
+        free(buf);
+}
+
+// foo.cに対してfoo.sを返す
+char *asm_path(char *path) {
+    char *base = strrchr(path, '/');
+    base = base ? base + 1 : path;
+    char *dot = strrchr(base, '.');
+    long len = dot && dot != base ? dot - path : (long)strlen(path);
+
+    char *buf = malloc(len + 3);
+    memcpy(buf, path, len);
+    strcpy(buf + len, ".s");
+    return buf;
+}
+
+typedef struct {
+    Context **ctxs;
+    bool *ok;
+} UnitJob;
+
+// 翻訳単位を1つコンパイルして，対応する.sファイルに書き出す
+static void compile_unit_job(void *arg, long i) {
+    UnitJob *job = arg;
+    Context *c = job->ctxs[i];
+    char *path = asm_path(c->filename);
+
+    OutFile *of = open_output(path);
+    if (!of) {
+        flockfile(stderr);
+        fprintf(stderr, "cannot open %s: %s\n", path, strerror(errno));
+        funlockfile(stderr);
+        free(path);
+        return;
+    }
+
+    // ファイル単位で並列に動いているので，関数単位の並列化はしない
+    Buffer *out = new_buffer(of->fd);
+    job->ok[i] = compile(c, c->filename, out, NULL);
+    if (job->ok[i])
+        buf_flush(out);
+    free_buffer(out);
+    if (!close_output(of, job->ok[i])) {
+        flockfile(stderr);
+        fprintf(stderr, "cannot write %s: %s\n", path, strerror(errno));
+        funlockfile(stderr);
+        job->ok[i] = false;
+    }
+    free(path);
+    ctx = NULL;
+}
+
+// "64M"のような大きさを読む．K, M, Gの接尾辞を付けられる．
+static long parse_size(char *s) {
+    char *end;
+    long n = strtol(s, &end, 10);
+    if (*end == 'K' || *end == 'M' || *end == 'G') {
+        n <<= *end == 'K' ? 10 : *end == 'M' ? 20 : 30;
+        end++;
+    }
+    if (end == s || *end || n <= 0)
+        error("invalid size: %s", s);
+    return n;
 }
 
 int main(int argc, char *argv[]) {
-    if (argc != 2) {
+    bool alloc_stats = false;
+    bool bench = false;
+    char *outpath = NULL;
+    int nthreads = 0;
+    char *server = NULL;
+    char *connect_to = NULL;
+    char *cache_dir = NULL;
+    long cache_size = 1L << 30;
+    bool cache_stats = false;
+    bool incremental = false;
+    bool dump_ir = false;
+    char *peephole_rules = "all";
+    bool peephole_stats = false;
+    char *local_only = NULL;    // クライアントでは効かないので--connectと一緒には使えないオプション
+    FileList inputs = {};
+
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--alloc-stats")) {
+            alloc_stats = true;
+            local_only = argv[i];
+            continue;
+        }
+        if (!strcmp(argv[i], "-o")) {
+            if (++i == argc)
+                error("%s: -o requires an argument", argv[0]);
+            outpath = argv[i];
+            continue;
+        }
+        if (!strncmp(argv[i], "-j", 2)) {
+            char *arg = argv[i][2] ? argv[i] + 2 : argv[++i];
+            if (!arg)
+                error("%s: -j requires an argument", argv[0]);
+            nthreads = atoi(arg);
+            continue;
+        }
+        if (!strcmp(argv[i], "--server")) {
+            if (++i == argc)
+                error("%s: --server requires a socket path", argv[0]);
+            server = argv[i];
+            continue;
+        }
+        if (!strcmp(argv[i], "--connect")) {
+            if (++i == argc)
+                error("%s: --connect requires a socket path", argv[0]);
+            connect_to = argv[i];
+            continue;
+        }
+        if (!strcmp(argv[i], "--cache-dir")) {
+            if (++i == argc)
+                error("%s: --cache-dir requires a directory", argv[0]);
+            cache_dir = argv[i];
+            local_only = argv[i - 1];
+            continue;
+        }
+        if (!strcmp(argv[i], "--cache-size")) {
+            if (++i == argc)
+                error("%s: --cache-size requires a size", argv[0]);
+            cache_size = parse_size(argv[i]);
+            local_only = argv[i - 1];
+            continue;
+        }
+        if (!strcmp(argv[i], "--incremental")) {
+            incremental = true;
+            local_only = argv[i];
+            continue;
+        }
+        if (!strcmp(argv[i], "--cache-stats")) {
+            cache_stats = true;
+            local_only = argv[i];
+            continue;
+        }
+        if (!strncmp(argv[i], "-fmax-errors=", 13)) {
+            // 0なら上限なしで，すべてのエラーを報告する
+            set_max_errors(atoi(argv[i] + 13));
+            local_only = argv[i];
+            continue;
+        }
+        if (!strcmp(argv[i], "--dump-ir")) {
+            dump_ir = true;
+            local_only = argv[i];
+            continue;
+        }
+        if (!strncmp(argv[i], "-fpeephole=", 11)) {
+            // カンマで区切った規則だけを使う
+            peephole_rules = argv[i] + 11;
+            local_only = argv[i];
+            continue;
+        }
+        if (!strcmp(argv[i], "-fno-peephole")) {
+            peephole_rules = "none";
+            local_only = argv[i];
+            continue;
+        }
+        if (!strcmp(argv[i], "--peephole-stats")) {
+            peephole_stats = true;
+            local_only = argv[i];
+            continue;
+        }
+        if (!strcmp(argv[i], "--bench-tokenize")) {
+            bench = true;
+            local_only = argv[i];
+            continue;
+        }
+        if (argv[i][0] == '@') {
+            read_response_file(&inputs, argv[i] + 1, 0);
+            continue;
+        }
+        add_file(&inputs, argv[i]);
+    }
+
+    // 要求はファイルしか運ばないので，出力を変えるオプションはサーバで効かない．
+    // キャッシュと統計もサーバの側にあるので，クライアントでは何も表示できない
+    if (connect_to && local_only)
+        error("%s: %s cannot be used with --connect", argv[0], local_only);
+
+    // サーバは終了するまで戻らない
+    init_scan();
+    if (dump_ir)
+        enable_dump_ir();
+    set_peephole(peephole_rules);
+    if (!connect_to) {
+        // 出力が変わるオプションはキャッシュのキーに混ぜる
+        char *flags = calloc(1, strlen(peephole_rules) + 32);
+        sprintf(flags, "%s -fpeephole=%s", dump_ir ? "--dump-ir" : "", peephole_rules);
+        cache_init(cache_dir, cache_size, flags);
+        if (incremental)
+            enable_incremental();
+    }
+    if (server) {
+        if (inputs.nfiles)
+            error("%s: --server takes no input files", argv[0]);
+        run_server(server, nthreads);
+    }
+
+    if (inputs.nfiles == 0)
         error("%s: invalid number of arguments", argv[0]);
+    if (connect_to)
+        return run_client(connect_to, inputs.files, inputs.nfiles, outpath);
+
+    if (bench) {
+        if (inputs.nfiles != 1)
+            error("%s: --bench-tokenize takes exactly one file", argv[0]);
+        ctx = new_context();
+        ctx->filename = inputs.files[0];
+        ctx->user_input = read_file(ctx->filename, &ctx->input_maplen);
+        bench_tokenize();
+        return 0;
+    }
+
+    ThreadPool *pool = new_pool(nthreads);
+    Context **ctxs = calloc(inputs.nfiles, sizeof(Context *));
+    for (long i = 0; i < inputs.nfiles; i++) {
+        ctxs[i] = new_context();
+        ctxs[i]->filename = inputs.files[i];
     }
 
-    // トークナイズしてパースする
-    filename = argv[1];
-    user_input = read_file(filename);
-    token = tokenize();
-    Program *prog = program();
-    add_type(prog);
+    bool ok = true;
+    if (inputs.nfiles == 1) {
+        // 出力先を開く．指定がなければ標準出力に書く
+        OutFile *of = open_output(outpath);
+        if (!of)
+            error("cannot open %s: %s", outpath, strerror(errno));
+        Buffer *out = new_buffer(of->fd);
+        ok = compile(ctxs[0], ctxs[0]->filename, out, pool);
+        if (ok)
+            buf_flush(out);
+        free_buffer(out);
+        if (!close_output(of, ok))
+            error("cannot write %s: %s", outpath, strerror(errno));
+    } else {
+        // 複数のファイルはそれぞれ独立にコンパイルし，foo.cをfoo.sに書き出す
+        if (outpath)
+            error("%s: cannot specify -o with multiple files", argv[0]);
 
-    // offsetを計算
-    for (Function *fn = prog->fns; fn; fn = fn->next) {
-        long offset = 0;
-        for (VarList *vl = fn->locals; vl; vl = vl->next) {
-            Var *var = vl->var;
-            offset += size_of(var->ty);
-            var->offset = offset;
-        }
-        fn->stack_size = offset;
+        UnitJob job;
+        job.ctxs = ctxs;
+        job.ok = calloc(inputs.nfiles, sizeof(bool));
+        pool_run(pool, inputs.nfiles, compile_unit_job, &job);
+        for (long i = 0; i < inputs.nfiles; i++)
+            ok = ok && job.ok[i];
+        free(job.ok);
     }
+    free_pool(pool);
 
-    codegen(prog);
-    return 0;
-}
\ No newline at end of file
+    // フロントエンドのオブジェクトをまとめて解放する
+    for (long i = 0; i < inputs.nfiles; i++) {
+        if (alloc_stats)
+            print_context_stats(ctxs[i]);
+        free_context(ctxs[i]);
+    }
+    free(ctxs);
+    if (cache_stats) {
+        print_cache_stats();
+        if (incremental)
+            print_inc_stats();
+    }
+    if (peephole_stats)
+        print_peephole_stats();
+    return ok ? 0 : 1;
+}
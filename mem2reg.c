@@ -0,0 +1,183 @@
+#include "gencc.h"
+
+// ローカル変数のレジスタへの昇格（mem2reg）．
+//
+// 下ろした直後の中間表現では，変数はすべてスタックに置かれ，IR_ADDRで得たアドレスを
+// 通して読み書きされる．関数のどのローカル変数のアドレスも，ロードとストアのアドレス
+// としてしか使われなければ，アドレスが外に漏れないので，変数をスタックの代わりに
+// 仮想レジスタに置ける．charは1バイトで読み書きするので，昇格するのは整数とポインタの
+// 変数だけである．
+//
+// こうした変数には専用の仮想レジスタを1つ割り当て，ロードとストアをIR_MOVに置き換える．
+// 変数のレジスタは代入のたびに定義されるので，定義が1か所とは限らない．
+// 置き換えた後は，次の2つで余分なIR_MOVを消す．
+// - 変数を読んだ値は，同じブロックの中で変数に代入し直すまで，変数のレジスタを直接使う
+// - 直前の命令の結果をそのまま変数に代入するときは，その命令が変数のレジスタに直接書く
+
+static bool promotable(Var *var) {
+    return var->is_local && (var->ty->kind == TY_INT || var->ty->kind == TY_PTR);
+}
+
+// 変数の仮想レジスタ．初めて見た変数には新しく割り当てる
+static int var_reg(IrFunc *f, Var *var) {
+    if (!var->reg)
+        var->reg = f->nregs++;
+    return var->reg;
+}
+
+// 変数を読んだ値の写し．copy_of[r]はrが写した変数のレジスタで，
+// rを作ったブロックの中で，その変数がcopy_ver[r]番目の定義のままなら，rの代わりに使える
+typedef struct {
+    int *copy_of;
+    long *copy_ver;
+    BB **copy_bb;
+    long *ver;      // 変数のレジスタごとの，これまでの定義の数
+} Copies;
+
+static int copy_source(Copies *c, BB *bb, int r) {
+    int v = c->copy_of[r];
+    if (v && c->copy_bb[r] == bb && c->copy_ver[r] == c->ver[v])
+        return v;
+    return r;
+}
+
+// 命令の被演算子のうち，変数の写しを変数のレジスタに置き換える
+static void replace_uses(Ir *ir, Copies *c, BB *bb) {
+    int *regs;
+    int nuses = ir_uses(ir, &regs);
+    if (ir->op == IR_CALL) {
+        for (int i = 0; i < nuses; i++)
+            ir->args[i] = copy_source(c, bb, ir->args[i]);
+        return;
+    }
+    if (nuses >= 1)
+        ir->a = copy_source(c, bb, ir->a);
+    if (nuses == 2)
+        ir->b = copy_source(c, bb, ir->b);
+}
+
+// ローカル変数のアドレスが，ロードとストアのアドレス以外に使われていればtrue．
+// ポインタの計算で隣の変数に届くことがあるので，1つでも漏れれば関数の変数をすべてスタックに残す
+static bool address_escapes(IrFunc *f, Var **addr_var) {
+    for (BB *bb = f->bbs; bb; bb = bb->next) {
+        for (Ir *ir = bb->first; ir; ir = ir->next) {
+            int *regs;
+            int nuses = ir_uses(ir, &regs);
+            for (int i = 0; i < nuses; i++)
+                if (addr_var[regs[i]] && !((ir->op == IR_LOAD || ir->op == IR_STORE) && i == 0))
+                    return true;
+        }
+    }
+    return false;
+}
+
+void mem2reg(IrFunc *f) {
+    // IR_ADDRでローカル変数のアドレスを持つレジスタから，その変数への表
+    Var **addr_var = calloc(f->nregs, sizeof(Var *));
+    for (BB *bb = f->bbs; bb; bb = bb->next)
+        for (Ir *ir = bb->first; ir; ir = ir->next)
+            if (ir->op == IR_ADDR && ir->var->is_local)
+                addr_var[ir->d] = ir->var;
+
+    bool escapes = address_escapes(f, addr_var);
+    for (VarList *vl = f->fn->locals; vl; vl = vl->next)
+        if (escapes || !promotable(vl->var))
+            vl->var->reg = -1;
+
+    // 昇格する変数のIR_ADDRを消し，ロードとストアを変数のレジスタとのIR_MOVにする
+    for (BB *bb = f->bbs; bb; bb = bb->next) {
+        Ir head = {};
+        Ir *cur = &head;
+        for (Ir *ir = bb->first; ir; ir = ir->next) {
+            Var *var = ir->op == IR_LOAD || ir->op == IR_STORE ? addr_var[ir->a] : ir->var;
+            bool promote = var && var->is_local && var->reg >= 0 &&
+                           (ir->op == IR_ADDR || ir->op == IR_LOAD || ir->op == IR_STORE || ir->op == IR_STORE_ARG);
+
+            if (promote && ir->op == IR_ADDR)
+                continue;
+            if (promote && ir->op == IR_LOAD) {
+                ir->op = IR_MOV;
+                ir->a = var_reg(f, var);
+            } else if (promote && ir->op == IR_STORE) {
+                ir->op = IR_MOV;
+                ir->d = var_reg(f, var);
+                ir->a = ir->b;
+                ir->b = 0;
+            } else if (promote && ir->op == IR_STORE_ARG) {
+                ir->op = IR_ARG;
+                ir->d = var_reg(f, var);
+            }
+            if (promote)
+                ir->size = 0;
+            cur = cur->next = ir;
+        }
+        cur->next = NULL;
+        bb->first = head.next;
+        bb->last = cur;
+    }
+
+    f->reg_var = arena_alloc(f->arena, sizeof(Var *) * f->nregs);
+    for (VarList *vl = f->fn->locals; vl; vl = vl->next) {
+        Var *var = vl->var;
+        if (var->reg > 0)
+            f->reg_var[var->reg] = var;
+        else
+            var->reg = 0;
+    }
+    free(addr_var);
+
+    // 変数を読んだ値の使用を，変数のレジスタに置き換える
+    Copies c;
+    c.copy_of = calloc(f->nregs, sizeof(int));
+    c.copy_ver = calloc(f->nregs, sizeof(long));
+    c.copy_bb = calloc(f->nregs, sizeof(BB *));
+    c.ver = calloc(f->nregs, sizeof(long));
+
+    for (BB *bb = f->bbs; bb; bb = bb->next) {
+        for (Ir *ir = bb->first; ir; ir = ir->next) {
+            replace_uses(ir, &c, bb);
+            if (ir->op == IR_MOV && f->reg_var[ir->a] && !f->reg_var[ir->d]) {
+                c.copy_of[ir->d] = ir->a;
+                c.copy_ver[ir->d] = c.ver[ir->a];
+                c.copy_bb[ir->d] = bb;
+            }
+            if (ir_defines(ir) && f->reg_var[ir->d])
+                c.ver[ir->d]++;
+        }
+    }
+
+    // 使われなくなった写しを消し，直前の結果を代入するだけのIR_MOVをその命令に畳み込む
+    int *nuses = calloc(f->nregs, sizeof(int));
+    for (BB *bb = f->bbs; bb; bb = bb->next) {
+        for (Ir *ir = bb->first; ir; ir = ir->next) {
+            int *regs;
+            int n = ir_uses(ir, &regs);
+            for (int i = 0; i < n; i++)
+                nuses[regs[i]]++;
+        }
+    }
+
+    for (BB *bb = f->bbs; bb; bb = bb->next) {
+        Ir head = {};
+        Ir *cur = &head;
+        for (Ir *ir = bb->first; ir; ir = ir->next) {
+            if (ir->op == IR_MOV && !f->reg_var[ir->d] && !nuses[ir->d])
+                continue;
+            if (ir->op == IR_MOV && f->reg_var[ir->d] && !f->reg_var[ir->a] && nuses[ir->a] == 1 &&
+                cur != &head && ir_defines(cur) && cur->d == ir->a) {
+                cur->d = ir->d;
+                continue;
+            }
+            cur = cur->next = ir;
+        }
+        cur->next = NULL;
+        bb->first = head.next;
+        bb->last = cur;
+    }
+
+    free(c.copy_of);
+    free(c.copy_ver);
+    free(c.copy_bb);
+    free(c.ver);
+    free(nuses);
+}
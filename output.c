@@ -0,0 +1,237 @@
+#include "gencc.h"
+
+// バッファがこの大きさを超えたらファイルに書き出す
+#define FLUSH_SIZE (1 << 20)
+
+// 出力先fdに書き出すバッファを作る．
+// fdが負の場合はメモリ上に溜めるだけで書き出さない．
+Buffer *new_buffer(int fd) {
+    Buffer *buf = calloc(1, sizeof(Buffer));
+    buf->fd = fd;
+    buf->cap = 64 * 1024;
+    buf->data = malloc(buf->cap);
+    return buf;
+}
+
+void free_buffer(Buffer *buf) {
+    free(buf->data);
+    free(buf);
+}
+
+// 溜まっている内容をすべて書き出す
+void buf_flush(Buffer *buf) {
+    if (buf->fd < 0)
+        return;
+
+    char *p = buf->data;
+    long len = buf->len;
+    while (len > 0) {
+        ssize_t n = write(buf->fd, p, len);
+        if (n < 0) {
+            if (errno == EINTR)
+                continue;
+            error("write failed: %s", strerror(errno));
+        }
+        p += n;
+        len -= n;
+    }
+    buf->len = 0;
+}
+
+// 少なくともnバイト追記できるようにする
+static void reserve(Buffer *buf, long n) {
+    if (buf->len + n <= buf->cap)
+        return;
+
+    if (buf->fd >= 0 && buf->len >= FLUSH_SIZE) {
+        buf_flush(buf);
+        if (n <= buf->cap)
+            return;
+    }
+
+    while (buf->cap < buf->len + n)
+        buf->cap *= 2;
+    buf->data = realloc(buf->data, buf->cap);
+    if (!buf->data)
+        error("out of memory");
+}
+
+void buf_write(Buffer *buf, char *p, long len) {
+    reserve(buf, len);
+    memcpy(buf->data + buf->len, p, len);
+    buf->len += len;
+}
+
+// fdからlenバイトを読み込んで追記する．読み切れなければ何も追記せずに偽を返す．
+bool buf_read(Buffer *buf, int fd, long len) {
+    reserve(buf, len);
+    long start = buf->len;
+    while (len > 0) {
+        ssize_t n = read(fd, buf->data + buf->len, len);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0) {
+            buf->len = start;
+            return false;
+        }
+        buf->len += n;
+        len -= n;
+    }
+    return true;
+}
+
+// fdの内容lenバイトを追記する．buf_readと同じく，読めなければ偽を返す．
+// 書き出し先がファイルなら，カーネルの中で直接コピーする．
+bool buf_copy_file(Buffer *buf, int fd, long len) {
+    if (buf->fd < 0)
+        return buf_read(buf, fd, len);
+
+    buf_flush(buf);
+    long done = 0;
+    while (done < len) {
+        ssize_t n = sendfile(buf->fd, fd, NULL, len - done);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0) {
+            // 1バイトも送っていなければ，普通に読み書きする
+            if (done == 0 && n < 0 && (errno == EINVAL || errno == ENOSYS))
+                return buf_read(buf, fd, len);
+            if (done == 0)
+                return false;
+            error("write failed: %s", n < 0 ? strerror(errno) : "unexpected end of file");
+        }
+        done += n;
+    }
+    return true;
+}
+
+void buf_puts(Buffer *buf, char *s) {
+    buf_write(buf, s, strlen(s));
+}
+
+void buf_putc(Buffer *buf, char c) {
+    reserve(buf, 1);
+    buf->data[buf->len++] = c;
+}
+
+// 整数を10進数で書き込む
+void buf_putl(Buffer *buf, long val) {
+    char tmp[24];
+    char *p = tmp + sizeof(tmp);
+    unsigned long u = val < 0 ? -(unsigned long)val : val;
+
+    do {
+        *--p = '0' + u % 10;
+        u /= 10;
+    } while (u);
+    if (val < 0)
+        *--p = '-';
+
+    buf_write(buf, p, tmp + sizeof(tmp) - p);
+}
+
+// printfの簡易版．%s, %d, %ld, %cと%%だけを扱う．
+void buf_vformat(Buffer *buf, char *fmt, va_list ap) {
+    char *p = fmt;
+    while (*p) {
+        char *q = p;
+        while (*q && *q != '%')
+            q++;
+        if (q != p)
+            buf_write(buf, p, q - p);
+        if (!*q)
+            return;
+
+        switch (q[1]) {
+            case 's':
+                buf_puts(buf, va_arg(ap, char *));
+                p = q + 2;
+                break;
+            case 'd':
+                buf_putl(buf, va_arg(ap, int));
+                p = q + 2;
+                break;
+            case 'c':
+                buf_putc(buf, va_arg(ap, int));
+                p = q + 2;
+                break;
+            case '%':
+                buf_putc(buf, '%');
+                p = q + 2;
+                break;
+            case 'l':
+                if (q[2] == 'd') {
+                    buf_putl(buf, va_arg(ap, long));
+                    p = q + 3;
+                    break;
+                }
+                // fallthrough
+            default:
+                error("unsupported format: %s", fmt);
+        }
+    }
+}
+
+void buf_format(Buffer *buf, char *fmt, ...) {
+    va_list ap;
+    va_start(ap, fmt);
+    buf_vformat(buf, fmt, ap);
+    va_end(ap);
+}
+
+// pathに書き出すファイルを開く．pathがNULLか"-"なら標準出力に書く．
+// 通常のファイルは一時ファイルに書くので，失敗しても元のファイルは残る．
+// 開けなければerrnoを設定してNULLを返す．
+OutFile *open_output(char *path) {
+    static atomic_long seq;
+    OutFile *of = calloc(1, sizeof(OutFile));
+    of->path = path;
+    if (!path || !strcmp(path, "-")) {
+        of->fd = STDOUT_FILENO;
+        return of;
+    }
+
+    // /dev/nullやパイプのような特殊なファイルは置き換えずに直接書く
+    struct stat st;
+    if (!stat(path, &st) && !S_ISREG(st.st_mode)) {
+        of->fd = open(path, O_WRONLY | O_TRUNC);
+        if (of->fd < 0) {
+            free(of);
+            return NULL;
+        }
+        return of;
+    }
+
+    of->tmppath = malloc(strlen(path) + 48);
+    sprintf(of->tmppath, "%s.%ld.%ld.tmp", path, (long)getpid(), atomic_fetch_add(&seq, 1));
+    of->fd = open(of->tmppath, O_WRONLY | O_CREAT | O_EXCL, 0644);
+    if (of->fd < 0) {
+        int err = errno;
+        free(of->tmppath);
+        free(of);
+        errno = err;
+        return NULL;
+    }
+    return of;
+}
+
+// 出力を閉じる．okなら一時ファイルをpathに置き換え，そうでなければ一時ファイルを消す．
+// 置き換えられなかったときは一時ファイルを消し，errnoを設定して偽を返す．
+bool close_output(OutFile *of, bool ok) {
+    if (of->fd != STDOUT_FILENO)
+        close(of->fd);
+
+    bool replaced = true;
+    if (of->tmppath) {
+        if (ok && rename(of->tmppath, of->path))
+            replaced = false;
+        if (!ok || !replaced) {
+            int err = errno;
+            unlink(of->tmppath);
+            errno = err;
+        }
+        free(of->tmppath);
+    }
+    free(of);
+    return replaced;
+}
@@ -1,149 +1,333 @@
 #include "gencc.h"
 
-VarList *scope;
-VarList *locals;
-VarList *globals;
+//
+// スコープ付きの変数表
+//
+// 名前（インターンしたポインタ）から，いま見えている変数をハッシュ表で引く．
+// 宣言するとその名前の束縛を積み，外側の同名の変数は隠される．
+// スコープを抜けるときは，その中で積んだ束縛をundo_logから逆順に取り除く．
+//
+
+struct Binding {
+    char *name;       // 変数の名前
+    Var *var;         // 変数
+    Binding *shadowed;// この束縛が隠している外側の束縛
+};
+
+struct ScopeSlot {
+    char *name;
+    Binding *top;     // いま見えている束縛
+};
+
+static unsigned long hash_ptr(char *p) {
+    return ((unsigned long)p >> 3) * 0x9E3779B97F4A7C15ul;
+}
+
+// 表を2倍に広げて入れ直す
+static void grow_scope_table(Scope *sc) {
+    long cap = sc->cap ? sc->cap * 2 : 1024;
+    ScopeSlot *table = calloc(cap, sizeof(ScopeSlot));
+
+    for (long i = 0; i < sc->cap; i++) {
+        ScopeSlot *s = &sc->slots[i];
+        if (!s->name)
+            continue;
+        long j = hash_ptr(s->name) & (cap - 1);
+        while (table[j].name)
+            j = (j + 1) & (cap - 1);
+        table[j] = *s;
+    }
+
+    free(sc->slots);
+    sc->slots = table;
+    sc->cap = cap;
+}
+
+// nameのスロットを返す．createが真ならなければ作る．
+static ScopeSlot *find_slot(char *name, bool create) {
+    Scope *sc = &ctx->scope;
+    if (create && sc->used * 2 >= sc->cap)
+        grow_scope_table(sc);
+    if (!sc->cap)
+        return NULL;
+
+    long i = hash_ptr(name) & (sc->cap - 1);
+    for (;;) {
+        ScopeSlot *s = &sc->slots[i];
+        if (s->name == name)
+            return s;
+        if (!s->name) {
+            if (!create)
+                return NULL;
+            s->name = name;
+            sc->used++;
+            return s;
+        }
+        i = (i + 1) & (sc->cap - 1);
+    }
+}
+
+// 変数をいまのスコープに登録する．
+static void push_scope(char *name, Var *var) {
+    Scope *sc = &ctx->scope;
+    ScopeSlot *s = find_slot(name, true);
+    Binding *b = arena_alloc(var->is_local ? &ctx->fn_arena : &ctx->parse_arena, sizeof(Binding));
+    b->name = name;
+    b->var = var;
+    b->shadowed = s->top;
+    s->top = b;
+
+    if (sc->undo_len == sc->undo_cap) {
+        sc->undo_cap = sc->undo_cap ? sc->undo_cap * 2 : 1024;
+        sc->undo_log = realloc(sc->undo_log, sizeof(Binding *) * sc->undo_cap);
+    }
+    sc->undo_log[sc->undo_len++] = b;
+}
+
+// 新しいスコープに入る．戻り値はleave_scopeに渡す．
+static long enter_scope() {
+    return ctx->scope.undo_len;
+}
+
+// enter_scopeより後に登録した変数をすべて見えなくする．
+static void leave_scope(long depth) {
+    Scope *sc = &ctx->scope;
+    while (sc->undo_len > depth) {
+        Binding *b = sc->undo_log[--sc->undo_len];
+        find_slot(b->name, false)->top = b->shadowed;
+    }
+}
+
+// 変数表を空にする．確保した領域は次の翻訳単位で使い回す．
+void reset_scope() {
+    Scope *sc = &ctx->scope;
+    memset(sc->slots, 0, sizeof(ScopeSlot) * sc->cap);
+    sc->used = 0;
+    sc->undo_len = 0;
+}
+
+// 変数表を捨てる．束縛はfn_arena, parse_arenaと一緒に解放する．
+void free_scope() {
+    free(ctx->scope.slots);
+    free(ctx->scope.undo_log);
+    ctx->scope = (Scope){0};
+}
+
+//
+// ノードの領域
+//
+// ノードは作った順に番号を振ってブロックに並べる．子は親より先に作るので，
+// 式の木はほぼ後置順に連続して並び，型付けやコード生成は前から順に読むことになる．
+//
 
 // 新しいノードを作成して，kindを設定する．
-Node *new_node(NodeKind kind, Token *tok) {
-    Node *node = calloc(1, sizeof(Node));
+NodeId new_node(NodeKind kind, Token *tok) {
+    NodePool *pool = &ctx->nodes;
+    if (pool->len == 0)
+        pool->len = 1; // 0番は使わない
+
+    long b = pool->len >> NODE_BLOCK_SHIFT;
+    if (b == pool->nblocks) {
+        pool->blocks = realloc(pool->blocks, sizeof(Node *) * (pool->nblocks + 1));
+        pool->blocks[pool->nblocks++] = malloc(sizeof(Node) << NODE_BLOCK_SHIFT);
+    }
+
+    NodeId id = pool->len++;
+    pool->total++;
+    if (pool->peak < pool->len)
+        pool->peak = pool->len;
+
+    Node *node = NODE(id);
+    memset(node, 0, sizeof(Node));
     node->kind = kind;
     node->tok = tok;
-    return node;
+    return id;
+}
+
+// ノードをすべて捨てる．ブロックは次の関数で使い回す．
+void reset_nodes() {
+    ctx->nodes.len = 0;
+}
+
+void free_nodes() {
+    NodePool *pool = &ctx->nodes;
+    for (long i = 0; i < pool->nblocks; i++)
+        free(pool->blocks[i]);
+    free(pool->blocks);
+    pool->blocks = NULL;
+    pool->nblocks = 0;
+    pool->len = 0;
 }
 
 // 2つの葉を持つノードを生成する．
-Node *new_binary(NodeKind kind, Node *lhs, Node *rhs, Token *tok) {
-    Node *node = new_node(kind, tok);
+NodeId new_binary(NodeKind kind, NodeId lhs, NodeId rhs, Token *tok) {
+    NodeId id = new_node(kind, tok);
+    Node *node = NODE(id);
     node->lhs = lhs;
     node->rhs = rhs;
-    return node;
+    add_type(node);
+    fold_expr(node);
+    return id;
 }
 
 // 1つの葉を持つノードを生成する．
-Node *new_unary(NodeKind kind, Node *expr, Token *tok) {
-    Node *node = new_node(kind, tok);
+NodeId new_unary(NodeKind kind, NodeId expr, Token *tok) {
+    NodeId id = new_node(kind, tok);
+    Node *node = NODE(id);
     node->lhs = expr;
-    return node;
+    add_type(node);
+    fold_expr(node);
+    return id;
 }
 
 // 数値を持つ葉を生成する．
-Node *new_num(long val, Token *tok) {
-    Node *node = new_node(ND_NUM, tok);
+NodeId new_num(long val, Token *tok) {
+    NodeId id = new_node(ND_NUM, tok);
+    Node *node = NODE(id);
     node->val = val;
-    return node;
+    add_type(node);
+    return id;
 }
 
 // 変数を持つ葉を生成する．
-Node *new_var(Var *var, Token *tok) {
-    Node *node = new_node(ND_VAR, tok);
+NodeId new_var(Var *var, Token *tok) {
+    NodeId id = new_node(ND_VAR, tok);
+    Node *node = NODE(id);
     node->var = var;
-    return node;
+    add_type(node);
+    return id;
+}
+
+// 文や引数のリストの末尾にidを繋げる
+static void append(NodeId *head, NodeId *tail, NodeId id) {
+    if (*tail)
+        NODE(*tail)->next = id;
+    else
+        *head = id;
+    *tail = id;
 }
 
 // 変数を名前で検索する．
 Var *find_var(Token *tok) {
-    for (VarList *vl = scope; vl; vl = vl->next) {
-        Var *var = vl->var;
-        if (strlen(var->name) == tok->len && !memcmp(tok->str, var->name, tok->len)) {
-            return var;
-        }
-    }
-
+    ScopeSlot *s = find_slot(tok->name, false);
+    if (s && s->top)
+        return s->top->var;
     return NULL;
 }
 
 // ローカル変数を追加する．
 Var *push_var(char *name, Type *ty, bool is_local) {
-    Var *var = calloc(1, sizeof(Var));
+    // ローカル変数は関数と一緒に解放する
+    Arena *arena = is_local ? &ctx->fn_arena : &ctx->parse_arena;
+    Var *var = arena_alloc(arena, sizeof(Var));
     var->name = name;
     var->ty = ty;
     var->is_local = is_local;
 
-    VarList *vl = calloc(1, sizeof(VarList));
+    VarList *vl = arena_alloc(arena, sizeof(VarList));
     vl->var = var;
 
     if (is_local) {
-        vl->next = locals;
-        locals = vl;
+        vl->next = ctx->locals;
+        ctx->locals = vl;
     } else {
-        vl->next = globals;
-        globals = vl;
+        vl->next = ctx->globals;
+        ctx->globals = vl;
     }
 
-    VarList *sc = calloc(1, sizeof(VarList));
-    sc->var = var;
-    sc->next = scope;
-    scope = sc;
+    push_scope(name, var);
 
     return var;
 }
 
 char *new_label() {
-    static int cnt = 0;
     char buf[20];
-    sprintf(buf, ".L.data.%d", cnt++);
-    return strndup(buf, 20);
+    sprintf(buf, ".L.data.%d", ctx->nlabels++);
+    return arena_strndup(&ctx->parse_arena, buf, strlen(buf));
 }
 
-bool is_function();
 Type *basetype();
 Type *struct_decl();
 Member *struct_member();
-void global_var();
+void global_var(Type *ty, char *name);
 Type *read_type_suffix(Type *base);
 VarList *read_func_param();
 VarList *read_func_params();
-Function *function();
-Node *declaration();
+Function *function(char *name);
+NodeId declaration();
 bool is_typename();
-Node *stmt();
-Node *read_expr_stmt();
-Node *expr();
-Node *assign();
-Node *equality();
-Node *relational();
-Node *add();
-Node *mul();
-Node *unary();
-Node *postfix();
-Node *func_args();
-Node *primary();
-
-// program = (global-var | function)*
-Program *program() {
-    Function head;
-    head.next = NULL;
-    Function *cur = &head;
-    globals = NULL;
+NodeId stmt();
+static NodeId read_stmt();
+NodeId read_expr_stmt();
+NodeId expr();
+static void reset_expr_stack();
 
+// トークナイズしたトップレベルの宣言を読む．関数を読んだらそれを返す．
+//
+// -fmax-errorsで複数のエラーを報告するときは，エラーのあった宣言の残りを捨てて
+// 次の宣言から読み続ける．宣言は1つずつトークナイズしているので，
+// 捨てるのはいまのトークン列だけでよい．
+static Function *top_decl() {
+    jmp_buf env;
+    long sc = enter_scope();
+    if (setjmp(env)) {
+        recover_errors(NULL);
+        leave_scope(sc);
+        reset_expr_stack();
+        return NULL;
+    }
+    recover_errors(&env);
+
+    // 宣言の終わりでトークン列は区切られているので，関数は最後にしか現れない
+    Function *fn = NULL;
     while (!at_eof()) {
-        if (is_function()) {
-            cur->next = function();
-            cur = cur->next;
-        } else {
-            global_var();
-        }
+        Type *ty = basetype();
+        char *name = expect_ident();
+
+        if (consume("("))
+            fn = function(name);
+        else
+            global_var(ty, name);
     }
 
-    Program *prog = calloc(1, sizeof(Program));
-    prog->global = globals;
-    prog->fns = head.next;
-    return prog;
+    // コード生成は別のスレッドで行うことがあるので，回復はここまで
+    recover_errors(NULL);
+    return fn;
 }
 
-bool is_function() {
-    Token *tok = token;
-    basetype();
-    bool isfunc = consume_ident() && consume("(");
-    token = tok;
-    return isfunc;
+// program = (basetype ident (global-var | function))*
+//
+// 型と名前を読んだ後の"("の有無で関数かグローバル変数かを判断するので，
+// 宣言を読み直すことはない．
+//
+// 宣言は1つずつトークナイズして読み，関数を読み終えるたびにemit_fnに渡す．
+// emit_fnはその関数のコードを生成して，tok_arenaとfn_arenaを空にしてよい．
+// 返すProgramにはグローバル変数だけが入っている．
+Program *program(void (*emit_fn)(Function *fn, void *arg), void *arg) {
+    ctx->globals = NULL;
+    reset_expr_stack();
+
+    for (;;) {
+        ctx->token = tokenize_decl();
+        if (at_eof())
+            break;
+
+        // エラーがあった後は，報告のために読むだけでコードは生成しない
+        Function *fn = top_decl();
+        if (fn && !ctx->nerrors)
+            emit_fn(fn, arg);
+    }
+
+    if (ctx->nerrors)
+        abort_compile();
+
+    Program *prog = arena_alloc(&ctx->parse_arena, sizeof(Program));
+    prog->global = ctx->globals;
+    return prog;
 }
 
-// global-var = basetype ident suffix ";"
-void global_var() {
-    Type *ty = basetype();
-    char *name = expect_ident();
+// global-var = suffix ";"
+void global_var(Type *ty, char *name) {
     ty = read_type_suffix(ty);
     expect(";");
     push_var(name, ty, false);
@@ -152,7 +336,7 @@ void global_var() {
 // basetype = ("int" | "char" | struct-dicl) "*"*
 Type *basetype() {
     if (!is_typename())
-        error_tok(token, "typename expected");
+        error_tok(ctx->token, "typename expected");
 
     Type *ty;
     if (consume("char"))
@@ -182,8 +366,7 @@ Type *struct_decl() {
         cur = cur->next;
     }
 
-    Type *ty = calloc(1, sizeof(Type));
-    ty->kind = TY_STRUCT;
+    Type *ty = new_type(TY_STRUCT);
     ty->members = head.next;
 
     // Assign offsets within the struct to members.
@@ -192,13 +375,16 @@ Type *struct_decl() {
         mem->offset = offset;
         offset += size_of(mem->ty);
     }
+    ty->size = offset;
+
+    build_member_index(ty);
 
     return ty;
 }
 
 // struct-member = basetype ident ("[" num "]")* ";"
 Member *struct_member() {
-    Member *mem = calloc(1, sizeof(Member));
+    Member *mem = arena_alloc(&ctx->parse_arena, sizeof(Member));
     mem->ty = basetype();
     mem->name = expect_ident();
     mem->ty = read_type_suffix(mem->ty);
@@ -223,7 +409,7 @@ VarList *read_func_param() {
     char *name = expect_ident();
     ty = read_type_suffix(ty);
 
-    VarList *vl = calloc(1, sizeof(VarList));
+    VarList *vl = arena_alloc(&ctx->fn_arena, sizeof(VarList));
     vl->var = push_var(name, ty, true);
     return vl;
 }
@@ -245,34 +431,41 @@ VarList *read_func_params() {
     return head;
 }
 
-// function = basetype ident "(" params? ")" "{" stmt* "}"
-Function *function() {
-    locals = NULL;
+// function = params? ")" "{" stmt* "}"
+Function *function(char *name) {
+    ctx->locals = NULL;
 
-    Function *fn = calloc(1, sizeof(Function));
-    basetype();
-    fn->name = expect_ident();
-    expect("(");
-    fn->params = read_func_params();
-    expect("{");
+    Function *fn = arena_alloc(&ctx->fn_arena, sizeof(Function));
+    fn->name = name;
+    VarList *globals = ctx->globals;
 
-    Node head;
-    head.next = NULL;
-    Node *cur = &head;
+    // 前回のコンパイルから変わっていなければ読み飛ばす
+    if (!reuse_function(fn)) {
+        // 引数とローカル変数は関数の外からは見えない
+        long sc = enter_scope();
+        fn->params = read_func_params();
+        expect("{");
 
-    while (!consume("}")) {
-        cur->next = stmt();
-        cur = cur->next;
+        NodeId head = 0, cur = 0;
+        while (!consume("}"))
+            append(&head, &cur, stmt());
+
+        leave_scope(sc);
+
+        fn->node = head;
+        fn->locals = ctx->locals;
     }
 
-    fn->node = head.next;
-    fn->locals = locals;
+    // 関数の中で増えたグローバル変数は文字列リテラル
+    fn->strings = ctx->globals;
+    for (VarList *vl = ctx->globals; vl != globals; vl = vl->next)
+        fn->nstrings++;
     return fn;
 }
 
 // declaration = basetype ident suffix? ("=" expr)? ";"
-Node *declaration() {
-    Token *tok = token;
+NodeId declaration() {
+    Token *tok = ctx->token;
     Type *ty = basetype();
     char *name = expect_ident();
     ty = read_type_suffix(ty);
@@ -282,10 +475,10 @@ Node *declaration() {
         return new_node(ND_NULL, tok);
 
     expect("=");
-    Node *lhs = new_var(var, tok);
-    Node *rhs = expr();
+    NodeId lhs = new_var(var, tok);
+    NodeId rhs = expr();
     expect(";");
-    Node *node = new_binary(ND_ASSIGN, lhs, rhs, tok);
+    NodeId node = new_binary(ND_ASSIGN, lhs, rhs, tok);
     return new_unary(ND_EXPR_STMT, node, tok);
 }
 
@@ -301,307 +494,421 @@ bool is_typename() {
 //      | "while" "(" expr ")" stmt
 //      | "for" "( expr? ";" expr? ";" expr? ")" stmt
 //      | "return" expr ";"
-Node *stmt() {
+//
+// ノードを作ってから子を読むときは，子を読み終えてからNODEで引き直して設定する．
+// 子を読む間にブロックの表が伸びることがあり，代入の左辺と右辺の評価順は決まっていないため．
+//
+// 条件が定数のif, while, forは読んだ後に畳み込む．
+NodeId stmt() {
+    return fold_stmt(read_stmt());
+}
+
+// 文を1つ読む．子の文は畳み込むが，この文自体は畳み込まない
+static NodeId read_stmt() {
     Token *tok;
     if ((tok = consume("{"))) {
-        Node *node = new_node(ND_BLOCK, tok);
+        NodeId node = new_node(ND_BLOCK, tok);
+        NodeId head = 0, cur = 0;
 
-        Node head;
-        head.next = NULL;
-        Node *cur = &head;
+        long sc = enter_scope();
+        while (!consume("}"))
+            append(&head, &cur, stmt());
+        leave_scope(sc);
 
-        VarList *sc = scope;
-        while (!consume("}")) {
-            cur->next = stmt();
-            cur = cur->next;
-        }
-        scope = sc;
-
-        node->body = head.next;
+        NODE(node)->body = head;
         return node;
     }
 
     if ((tok = consume("return"))) {
-        Node *node = new_unary(ND_RETURN, expr(), tok);
+        NodeId node = new_unary(ND_RETURN, expr(), tok);
         expect(";");
         return node;
     }
 
     if ((tok = consume("if"))) {
-        Node *node = new_node(ND_IF, tok);
+        NodeId node = new_node(ND_IF, tok);
         expect("(");
-        node->cond = expr();
+        NodeId cond = expr();
         expect(")");
-        node->then = stmt();
+        NodeId then = stmt();
+        NodeId els = 0;
         if (consume("else")) {
-            node->els = stmt();
+            els = stmt();
         }
+        NODE(node)->cond = cond;
+        NODE(node)->then = then;
+        NODE(node)->els = els;
         return node;
     }
 
     if ((tok =consume("while"))) {
-        Node *node = new_node(ND_WHILE, tok);
+        NodeId node = new_node(ND_WHILE, tok);
         expect("(");
-        node->cond = expr();
+        NodeId cond = expr();
         expect(")");
-        node->then = stmt();
+        NodeId then = stmt();
+        NODE(node)->cond = cond;
+        NODE(node)->then = then;
         return node;
     }
 
     if ((tok = consume("for"))) {
-        Node *node = new_node(ND_FOR, tok);
+        NodeId node = new_node(ND_FOR, tok);
+        NodeId init = 0, cond = 0, inc = 0;
         expect("(");
         if (!consume(";")) {
-            node->init = read_expr_stmt();
+            init = read_expr_stmt();
             expect(";");
         }
         if (!consume(";")) {
-            node->cond = expr();
+            cond = expr();
             expect(";");
         }
         if (!consume(")")) {
-            node->inc = read_expr_stmt();
+            inc = read_expr_stmt();
             expect(")");
         }
-        node->then = stmt();
+        NodeId then = stmt();
+        NODE(node)->init = init;
+        NODE(node)->cond = cond;
+        NODE(node)->inc = inc;
+        NODE(node)->then = then;
         return node;
     }
 
     if (is_typename())
         return declaration();
 
-    Node *node = read_expr_stmt();
+    NodeId node = read_expr_stmt();
     expect(";");
     return node;
 }
 
 // スタックにゴミを残さないように追加
-Node *read_expr_stmt() {
-    Token *tok = token;
+NodeId read_expr_stmt() {
+    Token *tok = ctx->token;
     return new_unary(ND_EXPR_STMT, expr(), tok);
 }
 
-// expr = assign
-Node *expr() {
-    return assign();
-}
-
-// assign = equality ("=" assign)?
-Node *assign() {
-    Node *node = equality();
-    Token *tok;
-    if ((tok = consume("="))) {
-        node = new_binary(ND_ASSIGN, node, assign(), tok);
-    }
-    return node;
-}
-
-// equality = relational ("==" relational | "!=" relational)*
-Node *equality() {
-    Node *node = relational();
-    Token *tok;
-
-    for (;;) {
-        if ((tok = consume("=="))) {
-            node = new_binary(ND_EQ, node, relational(), tok);
-        } else if ((tok = consume("!="))) {
-            node = new_binary(ND_NE, node, relational(), tok);
-        } else {
-            return node;
-        }
-    }
-}
-
+// expr       = assign
+// assign     = equality ("=" assign)?
+// equality   = relational ("==" relational | "!=" relational)*
 // relational = add ("<" add | "<=" add | ">" add | ">=" add)*
-Node *relational() {
-    Node *node = add();
+// add        = mul ("+" mul | "-" mul)*
+// mul        = unary ("*" unary | "/" unary)*
+// unary      = ("+" | "-" | "*" | "&" | "sizeof") unary
+//            | postfix
+// postfix    = primary ("[" expr "]" | "." ident)*
+// primary    = num
+//            | str
+//            | ident ("(" (assign ("," assign)*)? ")")?
+//            | "(" expr ")"
+//            | stmt-expr
+//
+// 式は再帰下降ではなく，演算子と被演算子のスタックを使った優先順位法で読む．
+// 括弧，添字，関数呼び出しの引数もスタックに印を積んで読むので，
+// 機械的に生成した深い入れ子や長い演算子の列でもCのスタックは伸びない．
+// 再帰するのは文の中の式（stmt-expr）だけである．
+
+// 式を読む途中で積む演算子と印
+typedef enum {
+    OP_BINARY,  // 二項演算子
+    OP_PREFIX,  // 前置の単項演算子
+    OP_PAREN,   // "(" expr ")"
+    OP_INDEX,   // "[" expr "]"
+    OP_CALL,    // 関数呼び出しの引数
+} OpKind;
+
+typedef struct {
+    OpKind kind;
+    NodeKind node_kind;
+    int prec;           // 優先順位．大きいほど強く結合する
+    bool swap;          // 左右を入れ替えて作る
     Token *tok;
-
-    for (;;) {
-        if ((tok = consume("<"))) {
-            node = new_binary(ND_LT, node, add(), tok);
-        } else if ((tok = consume("<="))) {
-            node = new_binary(ND_LE, node, add(), tok);
-        } else if ((tok = consume(">"))) {
-            node = new_binary(ND_LT, add(), node, tok);
-        } else if ((tok = consume(">="))) {
-            node = new_binary(ND_LE, add(), node, tok);
-        } else {
-            return node;
-        }
+    NodeId head;        // OP_INDEX: 添字を付ける式, OP_CALL: 読んだ引数のリスト
+    NodeId tail;
+} ExprOp;
+
+typedef struct {
+    char *op;
+    NodeKind kind;
+    int prec;
+    bool swap;          // ">"と">="は左右を入れ替えて"<"と"<="にする
+    bool right;         // 右結合
+} BinOp;
+
+static BinOp binops[] = {
+    { "=", ND_ASSIGN, 1, false, true },
+    { "==", ND_EQ, 2 },
+    { "!=", ND_NE, 2 },
+    { "<", ND_LT, 3 },
+    { "<=", ND_LE, 3 },
+    { ">", ND_LT, 3, true },
+    { ">=", ND_LE, 3, true },
+    { "+", ND_ADD, 4 },
+    { "-", ND_SUB, 4 },
+    { "*", ND_MUL, 5 },
+    { "/", ND_DIV, 5 },
+};
+
+// 前置の単項演算子はどの二項演算子よりも強く結合する
+#define PREFIX_PREC 6
+
+// 式のスタック．パースは翻訳単位ごとに1つのスレッドで行うので，スレッドごとに持つ
+static _Thread_local ExprOp *ops;
+static _Thread_local long nops;
+static _Thread_local long ops_cap;
+static _Thread_local NodeId *operands;
+static _Thread_local long noperands;
+static _Thread_local long operands_cap;
+
+static void push_op(ExprOp op) {
+    if (nops == ops_cap) {
+        ops_cap = ops_cap ? ops_cap * 2 : 64;
+        ops = realloc(ops, sizeof(ExprOp) * ops_cap);
     }
+    ops[nops++] = op;
 }
 
-// add = mul ("+" mul | "-" mul)*
-Node *add() {
-    Node *node = mul();
-    Token *tok;
-
-    for (;;) {
-        if ((tok = consume("+"))) {
-            node = new_binary(ND_ADD, node, mul(), tok);
-        } else if ((tok = consume("-"))) {
-            node = new_binary(ND_SUB, node, mul(), tok);
-        } else {
-            return node;
-        }
+static void push_operand(NodeId node) {
+    if (noperands == operands_cap) {
+        operands_cap = operands_cap ? operands_cap * 2 : 64;
+        operands = realloc(operands, sizeof(NodeId) * operands_cap);
     }
+    operands[noperands++] = node;
 }
 
-// mul = unary ("*" unary | "/" unary)*
-Node *mul() {
-    Node *node = unary();
-    Token *tok;
-
-    for (;;) {
-        if ((tok = consume("*"))) {
-            node = new_binary(ND_MUL, node, unary(), tok);
-        } else if ((tok = consume("/"))) {
-            node = new_binary(ND_DIV, node, unary(), tok);
-        } else {
-            return node;
-        }
-    }
+static NodeId pop_operand() {
+    return operands[--noperands];
 }
 
-// unary = ("+" | "-")? unary
-//       | ("*" | "&") unary
-//       | postfix
-Node *unary() {
-    Token *tok;
-    if (consume("+")) {
-        return unary();
-    }
-
-    if ((tok = consume("-"))) {
-        return new_binary(ND_SUB, new_num(0, tok), unary(), tok);
-    }
-
-    if ((tok = consume("*"))) {
-        return new_unary(ND_DEREF, unary(), tok);
-    }
+// エラーで途中から抜けた式の分も含めて，スタックを空にする
+static void reset_expr_stack() {
+    nops = 0;
+    noperands = 0;
+}
 
-    if ((tok = consume("&"))) {
-        return new_unary(ND_ADDR, unary(), tok);
+// 一番上の演算子を被演算子に適用する
+static void apply_op() {
+    ExprOp *op = &ops[--nops];
+    if (op->kind == OP_PREFIX) {
+        NodeId expr = pop_operand();
+        if (op->node_kind == ND_SUB)
+            push_operand(new_binary(ND_SUB, new_num(0, op->tok), expr, op->tok));
+        else
+            push_operand(new_unary(op->node_kind, expr, op->tok));
+        return;
     }
 
-    return postfix();
+    NodeId rhs = pop_operand();
+    NodeId lhs = pop_operand();
+    if (op->swap)
+        push_operand(new_binary(op->node_kind, rhs, lhs, op->tok));
+    else
+        push_operand(new_binary(op->node_kind, lhs, rhs, op->tok));
 }
 
-// postfix = primary ("[" expr "]" | "." ident)*
-Node *postfix() {
-    Node *node = primary();
-    Token *tok;
-
-    for (;;) {
-        if ((tok = consume("["))) {
-            // x[y] is short for *(x+y)
-            Node *exp = new_binary(ND_ADD, node, expr(), tok);
-            expect("]");
-            node = new_unary(ND_DEREF, exp, tok);
-            continue;
-        }
-
-        if ((tok = consume("."))) {
-            node = new_unary(ND_MEMBER, node, tok);
-            node->member_name = expect_ident();
-            continue;
-        }
-
-        return node;
-    }
+// base より上に積んだ，優先順位がprec以上の演算子を適用する．括弧などの印で止まる．
+static void reduce(long base, int prec) {
+    while (nops > base && (ops[nops - 1].kind == OP_BINARY || ops[nops - 1].kind == OP_PREFIX) &&
+           ops[nops - 1].prec >= prec)
+        apply_op();
 }
 
-// func_args = "(" ( assign ( "," assign )* )? ")"
-Node *func_args() {
-    if (consume(")"))
-        return NULL;
-
-    Node *head = assign();
-    Node *cur = head;
-    while (consume(",")) {
-        cur->next = assign();
-        cur = cur->next;
-    }
-
-    expect(")");
-    return head;
+static NodeId new_funcall(Token *tok, NodeId args) {
+    NodeId node = new_node(ND_FUNCALL, tok);
+    NODE(node)->funcname = tok->name;
+    NODE(node)->args = args;
+    add_type(NODE(node));
+    return node;
 }
 
 // stmt-expr = "(" "{" stmt stmt* "}" ")"
 //
 // GNUのC拡張である文の中に式を埋め込める機能です．
-Node *stmt_expr(Token *tok) {
-    VarList *sc = scope;
-
-    Node *node = new_node(ND_STMT_EXPR, tok);
-    node->body = stmt();
-    Node *cur = node->body;
+NodeId stmt_expr(Token *tok) {
+    long sc = enter_scope();
 
+    // 最後の文は，畳み込む前の種類で値を返せるかを調べる
+    NodeId node = new_node(ND_STMT_EXPR, tok);
+    NodeId head = 0, cur = 0;
+    NodeId last_stmt = read_stmt();
     while (!consume("}")) {
-        cur->next = stmt();
-        cur = cur->next;
+        append(&head, &cur, fold_stmt(last_stmt));
+        last_stmt = read_stmt();
     }
+    append(&head, &cur, last_stmt);
     expect(")");
 
-    scope = sc;
+    leave_scope(sc);
 
-    if (cur->kind != ND_EXPR_STMT)
-        error_tok(cur->tok, "stmt expr returning void is not supported");
-    *cur = *cur->lhs;
+    Node *last = NODE(cur);
+    if (last->kind != ND_EXPR_STMT)
+        error_tok(last->tok, "stmt expr returning void is not supported");
+    *last = *NODE(last->lhs);
+    NODE(node)->body = head;
+    add_type(NODE(node));
     return node;
 }
 
-// primary = num
-//         | str
-//         | ident func_args?
-//         | "(" expr ")"
-//         | "sizeof" unary
-//         | stmt-expr
-Node *primary() {
-    // 次のトークンが"("なら，"(" expr ")"のはず
-    if (consume("(")) {
-        if (consume("{"))
-            return stmt_expr(token->next);
 
-        Node *node = expr();
-        expect(")");
-        return node;
+// 前置演算子と，被演算子を1つ読んで積む．
+// 被演算子の代わりに"("などの印を積んだときは，中の式を読むために偽を返す．
+static bool read_operand() {
+    Token *tok;
+    for (;;) {
+        NodeKind kind;
+        if (consume("+"))
+            continue;
+        if ((tok = consume("-")))
+            kind = ND_SUB;
+        else if ((tok = consume("*")))
+            kind = ND_DEREF;
+        else if ((tok = consume("&")))
+            kind = ND_ADDR;
+        else if ((tok = consume("sizeof")))
+            kind = ND_SIZEOF;
+        else
+            break;
+        push_op((ExprOp){ .kind = OP_PREFIX, .node_kind = kind, .prec = PREFIX_PREC, .tok = tok });
+    }
+
+    if ((tok = consume("("))) {
+        if (consume("{")) {
+            push_operand(stmt_expr(ctx->token->next));
+            return true;
+        }
+        push_op((ExprOp){ .kind = OP_PAREN, .tok = tok });
+        return false;
     }
 
-    Token *tok;
     if ((tok = consume_ident())) {
         if (consume("(")) {
-            Node *node = new_node(ND_FUNCALL, tok);
-            node->funcname = strndup(tok->str, tok->len);
-            node->args = func_args();
-            return node;
+            if (consume(")")) {
+                push_operand(new_funcall(tok, 0));
+                return true;
+            }
+            push_op((ExprOp){ .kind = OP_CALL, .tok = tok });
+            return false;
         }
 
         Var *var = find_var(tok);
         if (!var) {
             error_tok(tok, "undefined variable");
         }
-        return new_var(var, tok);
-    }
-
-    if ((tok = consume("sizeof"))) {
-        return new_unary(ND_SIZEOF, unary(), tok);
+        push_operand(new_var(var, tok));
+        return true;
     }
 
-    tok = token;
+    tok = ctx->token;
     if (tok->kind == TK_STR) {
-        token = token->next;
+        ctx->token = ctx->token->next;
 
         Type *ty = array_of(char_type(), tok->cont_len);
+        // トークンは関数と一緒に解放するので，内容を写しておく
         Var *var = push_var(new_label(), ty, false);
-        var->contents = tok->contents;
+        var->contents = arena_alloc(&ctx->parse_arena, tok->cont_len);
+        memcpy(var->contents, tok->contents, tok->cont_len);
         var->cont_len = tok->cont_len;
-        return new_var(var, tok);
+        push_operand(new_var(var, tok));
+        return true;
     }
 
     if (tok->kind != TK_NUM)
         error_tok(tok, "expected expression");
     // そうでなければ数値のはず
-    return new_num(expect_number(), tok);
+    push_operand(new_num(expect_number(), tok));
+    return true;
+}
+
+// 一番上の被演算子に後置演算子を適用する．
+// "["を読んだら添字を読むために印を積んで偽を返す．
+static bool read_postfix() {
+    Token *tok;
+    for (;;) {
+        if ((tok = consume("["))) {
+            push_op((ExprOp){ .kind = OP_INDEX, .tok = tok, .head = pop_operand() });
+            return false;
+        }
+
+        if ((tok = consume("."))) {
+            NodeId node = operands[noperands - 1];
+            char *name = expect_ident();
+            Type *ty = NODE(node)->ty;
+            if (ty->kind != TY_STRUCT)
+                error_tok(tok, "not a struct");
+            Member *member = find_member(ty, name);
+            if (!member)
+                error_tok(tok, "no such member");
+
+            NodeId mem = new_node(ND_MEMBER, tok);
+            NODE(mem)->lhs = node;
+            NODE(mem)->member = member;
+            add_type(NODE(mem));
+            operands[noperands - 1] = mem;
+            continue;
+        }
+
+        return true;
+    }
+}
+
+static BinOp *consume_binop() {
+    for (int i = 0; i < sizeof(binops) / sizeof(*binops); i++)
+        if (consume(binops[i].op))
+            return &binops[i];
+    return NULL;
+}
+
+NodeId expr() {
+    long base = nops;
+
+    for (;;) {
+        while (!read_operand())
+            ;
+
+        // 被演算子の後ろを読む．閉じ括弧の後ろにはさらに演算子が続きうる
+        for (;;) {
+            if (!read_postfix())
+                break;
+
+            Token *tok = ctx->token;
+            BinOp *bin = consume_binop();
+            if (bin) {
+                // 右結合なら同じ優先順位の演算子は後で適用する
+                reduce(base, bin->right ? bin->prec + 1 : bin->prec);
+                push_op((ExprOp){ .kind = OP_BINARY, .node_kind = bin->kind, .prec = bin->prec,
+                                  .swap = bin->swap, .tok = tok });
+                break;
+            }
+
+            reduce(base, 0);
+            if (nops == base)
+                return pop_operand();
+
+            ExprOp *op = &ops[nops - 1];
+            if (op->kind == OP_PAREN) {
+                expect(")");
+                nops--;
+                continue;
+            }
+
+            if (op->kind == OP_INDEX) {
+                // x[y] is short for *(x+y)
+                NodeId exp = new_binary(ND_ADD, op->head, pop_operand(), op->tok);
+                expect("]");
+                push_operand(new_unary(ND_DEREF, exp, op->tok));
+                nops--;
+                continue;
+            }
+
+            // OP_CALL
+            append(&op->head, &op->tail, simplify(pop_operand()));
+            if (consume(","))
+                break;
+            expect(")");
+            push_operand(new_funcall(op->tok, op->head));
+            nops--;
+        }
+    }
 }
@@ -0,0 +1,557 @@
+#include "gencc.h"
+
+// 構造化したアセンブリと，のぞき穴最適化．
+//
+// コード生成は関数ごとに命令の列を作り，この最適化をかけてからテキストにする．
+// 命令の列は関数の中で閉じているので，ラベルとジャンプから制御の流れがわかる．
+// まず命令ごとに直後で生きているレジスタを求め，次の規則で命令を書き換える．
+// 消した命令はI_NOPにして残すので，ラベルの位置は変わらない．
+//
+//   dead    結果を使わないmov, movsx, movzx, leaと，同じレジスタへのmovを消す
+//   forward スタックに書いた直後に同じ場所を読むmovを，レジスタからのmovにする
+//   imm     movで即値を入れたレジスタを一度だけ使うなら，その命令の即値にする
+//   mem     leaでアドレスを入れたレジスタを一度だけ使うなら，その命令の[rbp-N]にする
+//   branch  setcc, movzx, cmp 0, jeの並びを，逆の条件のjccにする
+//   jump    直後のラベルへのjmpを消し，jccで飛び越すだけのjmpは条件を逆にしてjccにまとめる
+//
+// 規則は-fpeephole=で選べ，--peephole-statsで規則ごとの適用回数を表示する．
+
+// 使ったレジスタを探す範囲の命令数
+#define WINDOW 16
+
+// 書き換えがなくなるまで繰り返すが，この回数で打ち切る
+#define MAX_ROUNDS 8
+
+typedef enum {
+    RULE_DEAD,
+    RULE_FORWARD,
+    RULE_IMM,
+    RULE_MEM,
+    RULE_BRANCH,
+    RULE_JUMP,
+    NUM_RULES,
+} Rule;
+
+static struct {
+    char *name;
+    bool disabled;
+    atomic_long count;
+} rules[NUM_RULES] = {
+    [RULE_DEAD] = { "dead" },
+    [RULE_FORWARD] = { "forward" },
+    [RULE_IMM] = { "imm" },
+    [RULE_MEM] = { "mem" },
+    [RULE_BRANCH] = { "branch" },
+    [RULE_JUMP] = { "jump" },
+};
+
+// 使う規則をカンマ区切りで指定する．"all"ならすべて，"none"なら何も使わない
+void set_peephole(char *spec) {
+    for (int i = 0; i < NUM_RULES; i++)
+        rules[i].disabled = strcmp(spec, "all") != 0;
+    if (!strcmp(spec, "all") || !strcmp(spec, "none"))
+        return;
+
+    for (char *p = spec; *p;) {
+        long len = strcspn(p, ",");
+        int i = 0;
+        while (i < NUM_RULES && (strlen(rules[i].name) != len || strncmp(p, rules[i].name, len)))
+            i++;
+        if (i == NUM_RULES)
+            error("unknown peephole rule: %.*s", (int)len, p);
+        rules[i].disabled = false;
+        p += len;
+        if (*p == ',')
+            p++;
+    }
+}
+
+void print_peephole_stats() {
+    fprintf(stderr, "peephole:");
+    for (int i = 0; i < NUM_RULES; i++)
+        fprintf(stderr, "%s %ld %s", i ? "," : "", (long)rules[i].count, rules[i].name);
+    fprintf(stderr, "\n");
+}
+
+static bool use_rule(Rule rule) {
+    return !rules[rule].disabled;
+}
+
+// 適用した規則を数える．書き換えたことを返す
+static bool applied(Rule rule) {
+    rules[rule].count++;
+    return true;
+}
+
+//
+// レジスタの読み書き
+//
+
+static char *reg8_names[] = {
+    "rax", "rcx", "rdx", "rbx", "rsp", "rbp", "rsi", "rdi",
+    "r8", "r9", "r10", "r11", "r12", "r13", "r14", "r15",
+};
+
+static char *reg1_names[] = {
+    "al", "cl", "dl", "bl", "spl", "bpl", "sil", "dil",
+    "r8b", "r9b", "r10b", "r11b", "r12b", "r13b", "r14b", "r15b",
+};
+
+char *reg_name(Reg reg, int size) {
+    return size == 1 ? reg1_names[reg] : reg8_names[reg];
+}
+
+static unsigned bit(Reg reg) {
+    return 1u << reg;
+}
+
+// 関数を通してずっと生きているレジスタ
+#define ALWAYS_LIVE (bit(REG_RSP) | bit(REG_RBP))
+
+// 関数を呼ぶと壊れるレジスタ
+#define CALLER_SAVED                                                                         \
+    (bit(REG_RAX) | bit(REG_RCX) | bit(REG_RDX) | bit(REG_RSI) | bit(REG_RDI) | bit(REG_R8) | \
+     bit(REG_R9) | bit(REG_R10) | bit(REG_R11))
+
+#define ARG_REGS \
+    (bit(REG_RDI) | bit(REG_RSI) | bit(REG_RDX) | bit(REG_RCX) | bit(REG_R8) | bit(REG_R9))
+
+// 呼び出し元に返すときに生きているレジスタ
+#define RETURN_LIVE                                                                               \
+    (bit(REG_RAX) | bit(REG_RBX) | bit(REG_R12) | bit(REG_R13) | bit(REG_R14) | bit(REG_R15) | \
+     ALWAYS_LIVE)
+
+// 被演算子が値として読むレジスタ．メモリならアドレスのレジスタ
+static unsigned opd_uses(Operand *opd) {
+    if (opd->kind == OPD_REG || opd->kind == OPD_MEM)
+        return bit(opd->reg);
+    return 0;
+}
+
+// 結果を書くだけで，元の値を読まない命令
+static bool is_move(Insn *insn) {
+    return insn->op == I_MOV || insn->op == I_MOVSX || insn->op == I_MOVZX || insn->op == I_LEA;
+}
+
+// 命令が読むレジスタと書くレジスタ
+static void insn_regs(Insn *insn, unsigned *use, unsigned *def) {
+    Operand *dst = &insn->opd[0];
+    *use = 0;
+    *def = 0;
+    switch (insn->op) {
+        case I_MOV:
+        case I_MOVSX:
+        case I_MOVZX:
+        case I_LEA:
+            if (dst->kind == OPD_REG)
+                *def = bit(dst->reg);
+            else
+                *use = opd_uses(dst);
+            *use |= opd_uses(&insn->opd[1]);
+            return;
+        case I_ADD:
+        case I_SUB:
+        case I_IMUL:
+            *use = opd_uses(dst) | opd_uses(&insn->opd[1]);
+            if (dst->kind == OPD_REG)
+                *def = bit(dst->reg);
+            return;
+        case I_CMP:
+            *use = opd_uses(dst) | opd_uses(&insn->opd[1]);
+            return;
+        case I_SET:
+            // 下位8ビットだけを書くが，コード生成は直後に必ずmovzxで広げるので，
+            // 残りのビットを読む命令はない
+            *def = bit(dst->reg);
+            return;
+        case I_CQO:
+            *use = bit(REG_RAX);
+            *def = bit(REG_RDX);
+            return;
+        case I_IDIV:
+            *use = bit(REG_RAX) | bit(REG_RDX) | opd_uses(dst);
+            *def = bit(REG_RAX) | bit(REG_RDX);
+            return;
+        case I_CALL:
+            // raxには可変長引数のためにベクタレジスタの数を入れる
+            *use = ARG_REGS | bit(REG_RAX);
+            *def = CALLER_SAVED;
+            return;
+        case I_PUSH:
+            *use = opd_uses(dst) | bit(REG_RSP);
+            *def = bit(REG_RSP);
+            return;
+        case I_POP:
+            *use = bit(REG_RSP);
+            *def = bit(dst->reg) | bit(REG_RSP);
+            return;
+        case I_RET:
+            *use = RETURN_LIVE;
+            return;
+        default:
+            return;
+    }
+}
+
+static bool refers(Insn *insn, Reg reg) {
+    unsigned use, def;
+    insn_regs(insn, &use, &def);
+    return (use | def) & bit(reg);
+}
+
+static bool is_control(Insn *insn) {
+    return insn->op == I_LABEL || insn->op == I_JMP || insn->op == I_JCC || insn->op == I_CALL ||
+           insn->op == I_RET;
+}
+
+//
+// 生存解析
+//
+
+// 命令の列．消した命令を飛ばして辿る
+static _Thread_local Insn *insns;
+static _Thread_local long ninsns;
+static _Thread_local long *label_pos;   // ラベルの番号+1から，そのラベルの命令の位置
+static _Thread_local unsigned *live_in;
+static _Thread_local unsigned *live_out;
+
+static long next_insn(long i) {
+    do
+        i++;
+    while (i < ninsns && insns[i].op == I_NOP);
+    return i;
+}
+
+static long target(Insn *insn) {
+    return label_pos[insn->opd[0].val + 1];
+}
+
+// 各命令の直後で生きているレジスタを求める．ループがあるので変わらなくなるまで繰り返す
+static void liveness() {
+    memset(live_in, 0, sizeof(unsigned) * ninsns);
+    for (bool changed = true; changed;) {
+        changed = false;
+        for (long i = ninsns - 1; i >= 0; i--) {
+            Insn *insn = &insns[i];
+            unsigned out = i + 1 < ninsns ? live_in[i + 1] : 0;
+            if (insn->op == I_JMP)
+                out = live_in[target(insn)];
+            else if (insn->op == I_JCC)
+                out |= live_in[target(insn)];
+            else if (insn->op == I_RET)
+                out = 0;
+            live_out[i] = out | ALWAYS_LIVE;
+
+            unsigned use, def;
+            insn_regs(insn, &use, &def);
+            unsigned in = use | (out & ~def);
+            if (in != live_in[i]) {
+                live_in[i] = in;
+                changed = true;
+            }
+        }
+    }
+}
+
+//
+// 書き換えの規則
+//
+
+static bool same_opd(Operand *a, Operand *b) {
+    return a->kind == b->kind && a->reg == b->reg && a->size == b->size && a->val == b->val;
+}
+
+static CondCode invert(CondCode cc) {
+    static CondCode inv[] = {
+        [CC_E] = CC_NE, [CC_NE] = CC_E, [CC_L] = CC_GE,
+        [CC_LE] = CC_G, [CC_G] = CC_LE, [CC_GE] = CC_L,
+    };
+    return inv[cc];
+}
+
+// 結果を使わない命令を消す
+static bool remove_dead(long i) {
+    Insn *insn = &insns[i];
+    if (!is_move(insn) || insn->opd[0].kind != OPD_REG)
+        return false;
+    Reg dst = insn->opd[0].reg;
+    if (!(live_out[i] & bit(dst)) || (insn->op == I_MOV && same_opd(&insn->opd[0], &insn->opd[1]))) {
+        insn->op = I_NOP;
+        return applied(RULE_DEAD);
+    }
+    return false;
+}
+
+// mov [rbp-N], reg の直後の mov reg2, [rbp-N] を mov reg2, reg にする
+static bool forward_store(long i) {
+    Insn *st = &insns[i];
+    if (st->op != I_MOV || st->opd[0].kind != OPD_MEM || st->opd[0].reg != REG_RBP ||
+        st->opd[0].size != 8 || st->opd[1].kind != OPD_REG)
+        return false;
+
+    long j = next_insn(i);
+    if (j == ninsns)
+        return false;
+    Insn *ld = &insns[j];
+    if (ld->op != I_MOV || ld->opd[0].kind != OPD_REG || !same_opd(&ld->opd[1], &st->opd[0]))
+        return false;
+    ld->opd[1] = st->opd[1];
+    if (ld->opd[0].reg == st->opd[1].reg)
+        ld->op = I_NOP;
+    return applied(RULE_FORWARD);
+}
+
+// defでregに入れた値を最初に使う命令を探す．途中で制御が分かれたり，regを書いたりすれば-1を返す
+static long find_use(long i, Reg reg) {
+    long j = next_insn(i);
+    for (int k = 0; k < WINDOW && j < ninsns; k++, j = next_insn(j)) {
+        if (is_control(&insns[j]))
+            return -1;
+        if (refers(&insns[j], reg))
+            return j;
+    }
+    return -1;
+}
+
+// mov reg, imm をregの唯一の使用に畳み込む
+static bool fold_imm(long i) {
+    Insn *def = &insns[i];
+    if (def->op != I_MOV || def->opd[0].kind != OPD_REG || def->opd[1].kind != OPD_IMM ||
+        def->opd[1].val != (int)def->opd[1].val)
+        return false;
+
+    Reg reg = def->opd[0].reg;
+    long j = find_use(i, reg);
+    if (j < 0)
+        return false;
+
+    // 即値を取れるのは右の被演算子だけで，そこで最後に使うときだけ畳み込める
+    Insn *use = &insns[j];
+    bool ok = use->op == I_MOV || use->op == I_ADD || use->op == I_SUB || use->op == I_IMUL ||
+              use->op == I_CMP;
+    Operand *src = &use->opd[1];
+    if (!ok || src->kind != OPD_REG || src->reg != reg || src->size != 8 ||
+        (opd_uses(&use->opd[0]) & bit(reg)) || (live_out[j] & bit(reg)))
+        return false;
+    if (use->op == I_IMUL && use->opd[0].kind != OPD_REG)
+        return false;
+
+    *src = def->opd[1];
+    def->op = I_NOP;
+    return applied(RULE_IMM);
+}
+
+// lea reg, [rbp-N] をregの唯一の使用の[reg]に畳み込む
+static bool fold_mem(long i) {
+    Insn *def = &insns[i];
+    if (def->op != I_LEA || def->opd[0].kind != OPD_REG || def->opd[1].reg != REG_RBP)
+        return false;
+
+    Reg reg = def->opd[0].reg;
+    long j = find_use(i, reg);
+    if (j < 0)
+        return false;
+
+    // regを[reg]としてだけ使う．結果をregに書くなら元の値は要らない
+    Insn *use = &insns[j];
+    Operand *addr = NULL;
+    bool redefined = false;
+    for (int k = 0; k < 2; k++) {
+        Operand *opd = &use->opd[k];
+        if (opd->kind == OPD_MEM && opd->reg == reg && opd->val == 0 && !addr)
+            addr = opd;
+        else if (k == 0 && is_move(use) && opd->kind == OPD_REG && opd->reg == reg)
+            redefined = true;
+        else if (opd_uses(opd) & bit(reg))
+            return false;
+    }
+    if (!addr || (!redefined && (live_out[j] & bit(reg))))
+        return false;
+
+    addr->reg = REG_RBP;
+    addr->val = def->opd[1].val;
+    def->op = I_NOP;
+    return applied(RULE_MEM);
+}
+
+// setcc al; movzx reg, al; cmp reg, 0; je L を j(逆の条件) L にする
+static bool fuse_branch(long i) {
+    Insn *set = &insns[i];
+    if (set->op != I_SET)
+        return false;
+    long j1 = next_insn(i);
+    long j2 = j1 < ninsns ? next_insn(j1) : ninsns;
+    long j3 = j2 < ninsns ? next_insn(j2) : ninsns;
+    if (j3 >= ninsns)
+        return false;
+
+    Insn *ext = &insns[j1];
+    Insn *cmp = &insns[j2];
+    Insn *br = &insns[j3];
+    if (ext->op != I_MOVZX || ext->opd[0].kind != OPD_REG || ext->opd[1].reg != set->opd[0].reg)
+        return false;
+    Reg reg = ext->opd[0].reg;
+    if (cmp->op != I_CMP || cmp->opd[0].kind != OPD_REG || cmp->opd[0].reg != reg ||
+        cmp->opd[1].kind != OPD_IMM || cmp->opd[1].val != 0)
+        return false;
+    if (br->op != I_JCC || br->cc != CC_E)
+        return false;
+    if (live_out[j3] & (bit(reg) | bit(set->opd[0].reg)))
+        return false;
+
+    br->cc = invert(set->cc);
+    set->op = I_NOP;
+    ext->op = I_NOP;
+    cmp->op = I_NOP;
+    return applied(RULE_BRANCH);
+}
+
+// 命令jの直後に，ラベルlabelが来るか
+static bool falls_into(long j, long label) {
+    for (j = next_insn(j); j < ninsns && insns[j].op == I_LABEL; j = next_insn(j))
+        if (insns[j].opd[0].val == label)
+            return true;
+    return false;
+}
+
+// jmp L; L: のjmpを消し，jcc A; jmp B; A: をj(逆の条件) B; A: にする
+static bool thread_jump(long i) {
+    Insn *insn = &insns[i];
+    if (insn->op == I_JMP && falls_into(i, insn->opd[0].val)) {
+        insn->op = I_NOP;
+        return applied(RULE_JUMP);
+    }
+
+    if (insn->op != I_JCC)
+        return false;
+    long j = next_insn(i);
+    if (j == ninsns || insns[j].op != I_JMP || !falls_into(j, insn->opd[0].val))
+        return false;
+    insn->cc = invert(insn->cc);
+    insn->opd[0] = insns[j].opd[0];
+    insns[j].op = I_NOP;
+    return applied(RULE_JUMP);
+}
+
+static bool rewrite(long i) {
+    return (use_rule(RULE_DEAD) && remove_dead(i)) ||
+           (use_rule(RULE_FORWARD) && forward_store(i)) ||
+           (use_rule(RULE_IMM) && fold_imm(i)) ||
+           (use_rule(RULE_MEM) && fold_mem(i)) ||
+           (use_rule(RULE_BRANCH) && fuse_branch(i)) ||
+           (use_rule(RULE_JUMP) && thread_jump(i));
+}
+
+// 1つの関数の命令の列に，のぞき穴最適化をかける．
+// ラベルの番号は0からnlabels-1までとRETURN_LABELである．
+void peephole(Insn *code, long n, int nlabels) {
+    bool any = false;
+    for (int i = 0; i < NUM_RULES; i++)
+        any = any || use_rule(i);
+    if (!any)
+        return;
+
+    insns = code;
+    ninsns = n;
+    label_pos = calloc(nlabels + 1, sizeof(long));
+    live_in = malloc(sizeof(unsigned) * n);
+    live_out = malloc(sizeof(unsigned) * n);
+    for (long i = 0; i < n; i++)
+        if (code[i].op == I_LABEL)
+            label_pos[code[i].opd[0].val + 1] = i;
+
+    for (int round = 0; round < MAX_ROUNDS; round++) {
+        liveness();
+        bool changed = false;
+        for (long i = 0; i < n; i++)
+            if (code[i].op != I_NOP && rewrite(i))
+                changed = true;
+        if (!changed)
+            break;
+    }
+
+    free(label_pos);
+    free(live_in);
+    free(live_out);
+    insns = NULL;
+}
+
+//
+// 出力
+//
+
+static char *mnemonics[] = {
+    [I_MOV] = "mov", [I_MOVSX] = "movsx", [I_MOVZX] = "movzx", [I_LEA] = "lea",
+    [I_ADD] = "add", [I_SUB] = "sub", [I_IMUL] = "imul", [I_CQO] = "cqo",
+    [I_IDIV] = "idiv", [I_CMP] = "cmp", [I_SET] = "set", [I_JMP] = "jmp",
+    [I_JCC] = "j", [I_CALL] = "call", [I_PUSH] = "push", [I_POP] = "pop",
+    [I_RET] = "ret",
+};
+
+static char *cc_names[] = {
+    [CC_E] = "e", [CC_NE] = "ne", [CC_L] = "l", [CC_LE] = "le", [CC_G] = "g", [CC_GE] = "ge",
+};
+
+static void print_label(Buffer *out, long label, char *funcname) {
+    if (label == RETURN_LABEL)
+        buf_format(out, ".Lreturn.%s", funcname);
+    else
+        buf_format(out, ".Lbb.%s.%ld", funcname, label);
+}
+
+// sizedなら，メモリの大きさをレジスタから決められないのでptrを付ける
+static void print_operand(Buffer *out, Insn *insn, Operand *opd, bool sized, char *funcname) {
+    switch (opd->kind) {
+        case OPD_REG:
+            buf_puts(out, reg_name(opd->reg, opd->size));
+            return;
+        case OPD_IMM:
+            buf_format(out, "%ld", opd->val);
+            return;
+        case OPD_MEM:
+            if (opd->size == 1)
+                buf_puts(out, "byte ptr ");
+            else if (sized)
+                buf_puts(out, "qword ptr ");
+            if (opd->val < 0)
+                buf_format(out, "[%s-%ld]", reg_name(opd->reg, 8), -opd->val);
+            else if (opd->val > 0)
+                buf_format(out, "[%s+%ld]", reg_name(opd->reg, 8), opd->val);
+            else
+                buf_format(out, "[%s]", reg_name(opd->reg, 8));
+            return;
+        case OPD_SYM:
+            buf_format(out, insn->op == I_CALL ? "%s" : "offset %s", opd->sym);
+            return;
+        case OPD_LABEL:
+            print_label(out, opd->val, funcname);
+            return;
+        default:
+            return;
+    }
+}
+
+void print_insns(Buffer *out, Insn *code, long n, char *funcname) {
+    for (long i = 0; i < n; i++) {
+        Insn *insn = &code[i];
+        if (insn->op == I_NOP)
+            continue;
+        if (insn->op == I_LABEL) {
+            print_label(out, insn->opd[0].val, funcname);
+            buf_puts(out, ":\n");
+            continue;
+        }
+
+        buf_puts(out, "    ");
+        buf_puts(out, mnemonics[insn->op]);
+        if (insn->op == I_SET || insn->op == I_JCC)
+            buf_puts(out, cc_names[insn->cc]);
+
+        bool sized = insn->opd[0].kind != OPD_REG && insn->opd[1].kind != OPD_REG;
+        for (int k = 0; k < 2 && insn->opd[k].kind != OPD_NONE; k++) {
+            buf_puts(out, k ? ", " : " ");
+            print_operand(out, insn, &insn->opd[k], sized, funcname);
+        }
+        buf_putc(out, '\n');
+    }
+}
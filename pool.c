@@ -0,0 +1,136 @@
+#include "gencc.h"
+
+// スレッドプール．
+//
+// pool_runに渡した仕事0..njobs-1を，ワーカーと呼び出し元のスレッドで分け合う．
+// 各スレッドは共有のカウンタから次の番号を1つずつ取っていくので，
+// 重い仕事に当たったスレッドがあっても，残りは空いているスレッドが引き受ける．
+
+struct ThreadPool {
+    int nthreads;           // 呼び出し元を含むスレッド数
+    pthread_t *threads;
+
+    pthread_mutex_t mu;
+    pthread_cond_t start;   // 新しい仕事が来た
+    pthread_cond_t done;    // すべてのワーカーが仕事を終えた
+    long generation;        // pool_runのたびに増える
+    int running;            // 仕事中のワーカー数
+    bool busy;              // pool_runがワーカーを使っている
+    bool shutdown;
+
+    // いま実行している仕事
+    void (*fn)(void *arg, long i);
+    void *arg;
+    long njobs;
+    atomic_long next;       // 次に取る仕事の番号
+};
+
+// 仕事がなくなるまで取っては実行する
+static void run_jobs(ThreadPool *pool) {
+    for (;;) {
+        long i = atomic_fetch_add(&pool->next, 1);
+        if (i >= pool->njobs)
+            return;
+        pool->fn(pool->arg, i);
+    }
+}
+
+static void *worker(void *arg) {
+    ThreadPool *pool = arg;
+    long seen = 0;
+
+    pthread_mutex_lock(&pool->mu);
+    for (;;) {
+        while (pool->generation == seen && !pool->shutdown)
+            pthread_cond_wait(&pool->start, &pool->mu);
+        if (pool->shutdown)
+            break;
+        seen = pool->generation;
+        pthread_mutex_unlock(&pool->mu);
+
+        run_jobs(pool);
+
+        pthread_mutex_lock(&pool->mu);
+        if (--pool->running == 0)
+            pthread_cond_signal(&pool->done);
+    }
+    pthread_mutex_unlock(&pool->mu);
+    return NULL;
+}
+
+// 呼び出し元を含めてnthreads個のスレッドで仕事をするプールを作る．
+// nthreadsが0以下ならCPUの数だけ使う．
+ThreadPool *new_pool(int nthreads) {
+    if (nthreads <= 0)
+        nthreads = sysconf(_SC_NPROCESSORS_ONLN);
+    if (nthreads <= 0)
+        nthreads = 1;
+
+    ThreadPool *pool = calloc(1, sizeof(ThreadPool));
+    pool->nthreads = nthreads;
+    pthread_mutex_init(&pool->mu, NULL);
+    pthread_cond_init(&pool->start, NULL);
+    pthread_cond_init(&pool->done, NULL);
+
+    pool->threads = calloc(nthreads, sizeof(pthread_t));
+    for (int i = 1; i < nthreads; i++)
+        if (pthread_create(&pool->threads[i], NULL, worker, pool))
+            error("cannot create a thread");
+    return pool;
+}
+
+void free_pool(ThreadPool *pool) {
+    pthread_mutex_lock(&pool->mu);
+    pool->shutdown = true;
+    pthread_cond_broadcast(&pool->start);
+    pthread_mutex_unlock(&pool->mu);
+
+    for (int i = 1; i < pool->nthreads; i++)
+        pthread_join(pool->threads[i], NULL);
+
+    pthread_mutex_destroy(&pool->mu);
+    pthread_cond_destroy(&pool->start);
+    pthread_cond_destroy(&pool->done);
+    free(pool->threads);
+    free(pool);
+}
+
+int pool_size(ThreadPool *pool) {
+    return pool->nthreads;
+}
+
+// fn(arg, 0)からfn(arg, njobs - 1)までを並列に実行し，すべて終わるまで待つ．
+// どの順番で，どのスレッドで実行されるかは決まっていない．
+// 別のスレッドがワーカーを使っている間は，呼び出し元のスレッドだけで順に実行する．
+void pool_run(ThreadPool *pool, long njobs, void (*fn)(void *arg, long i), void *arg) {
+    bool serial = pool->nthreads == 1 || njobs <= 1;
+    if (!serial) {
+        pthread_mutex_lock(&pool->mu);
+        serial = pool->busy;
+        pool->busy = true;
+        if (serial)
+            pthread_mutex_unlock(&pool->mu);
+    }
+    if (serial) {
+        for (long i = 0; i < njobs; i++)
+            fn(arg, i);
+        return;
+    }
+
+    pool->fn = fn;
+    pool->arg = arg;
+    pool->njobs = njobs;
+    atomic_store(&pool->next, 0);
+    pool->running = pool->nthreads - 1;
+    pool->generation++;
+    pthread_cond_broadcast(&pool->start);
+    pthread_mutex_unlock(&pool->mu);
+
+    run_jobs(pool);
+
+    pthread_mutex_lock(&pool->mu);
+    while (pool->running > 0)
+        pthread_cond_wait(&pool->done, &pool->mu);
+    pool->busy = false;
+    pthread_mutex_unlock(&pool->mu);
+}
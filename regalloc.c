@@ -0,0 +1,236 @@
+#include "gencc.h"
+
+// 線形走査によるレジスタ割り当て．
+//
+// 命令に配置順の通し番号を振り，仮想レジスタごとに生きている区間を求める．
+// i番目の命令は位置2iで被演算子を読み，位置2i+1で結果を書くので，
+// その命令で最後に使われたレジスタの物理レジスタを結果に使い回せる．
+// ほとんどのレジスタは定義したブロックの中だけで使われるので，区間は定義から最後の使用までになる．
+// ブロックをまたいで使われるレジスタと，何度も定義される変数のレジスタだけを
+// ブロック単位の生存解析にかけ，区間を広げる．
+//
+// 区間を始点の順に見て，空いている物理レジスタを割り当てる．空いていなければ，
+// 終点がいちばん遠い区間を丸ごとスピルしてスタックフレームに置く．
+//
+// 引数を渡すレジスタとrax, rdxは割り当てに使わないので，コード生成は関数呼び出しの
+// 引数を並べるときや割り算で衝突を気にしなくてよい．
+// 関数呼び出しをまたぐ区間には呼び出し先保存のレジスタだけを割り当てる．
+
+Reg phys_regs[] = { REG_R10, REG_R11, REG_RBX, REG_R12, REG_R13, REG_R14, REG_R15 };
+
+typedef struct {
+    int reg;            // 仮想レジスタ
+    int start;
+    int end;
+    bool across_call;   // 区間の途中に関数呼び出しがある
+} Interval;
+
+static int compare_start(const void *x, const void *y) {
+    const Interval *a = *(Interval **)x;
+    const Interval *b = *(Interval **)y;
+    if (a->start != b->start)
+        return a->start < b->start ? -1 : 1;
+    return a->reg - b->reg;
+}
+
+// ブロックをまたいで使われるレジスタの生存区間を，ブロック単位の生存解析で広げる．
+// globalは仮想レジスタからブロックをまたぐレジスタの通し番号（-1ならまたがない）への表
+static void extend_global(IrFunc *f, BB **bbs, int *bb_start, int *bb_end,
+                          int *global, int nglobals, Interval *iv) {
+    long nwords = (nglobals + 63) / 64;
+    unsigned long *gen = calloc(f->nbbs * nwords, sizeof(long));
+    unsigned long *kill = calloc(f->nbbs * nwords, sizeof(long));
+    unsigned long *in = calloc(f->nbbs * nwords, sizeof(long));
+    unsigned long *out = calloc(f->nbbs * nwords, sizeof(long));
+
+    // ブロックの中で定義より前に読むレジスタと，定義するレジスタ
+    for (int b = 0; b < f->nbbs; b++) {
+        unsigned long *g = gen + b * nwords;
+        unsigned long *k = kill + b * nwords;
+        for (Ir *ir = bbs[b]->first; ir; ir = ir->next) {
+            int *regs;
+            int nuses = ir_uses(ir, &regs);
+            for (int i = 0; i < nuses; i++) {
+                int x = global[regs[i]];
+                if (x >= 0 && !(k[x / 64] & (1ul << (x % 64))))
+                    g[x / 64] |= 1ul << (x % 64);
+            }
+            if (ir_defines(ir) && global[ir->d] >= 0)
+                k[global[ir->d] / 64] |= 1ul << (global[ir->d] % 64);
+        }
+    }
+
+    // 飛び先は後ろのブロックであることが多いので，後ろから順に更新する
+    for (bool changed = true; changed;) {
+        changed = false;
+        for (int b = f->nbbs - 1; b >= 0; b--) {
+            unsigned long *o = out + b * nwords;
+            BB *succs[2];
+            int nsuccs = bb_succs(bbs[b], succs);
+            for (int i = 0; i < nsuccs; i++)
+                for (long w = 0; w < nwords; w++)
+                    o[w] |= in[succs[i]->label * nwords + w];
+
+            for (long w = 0; w < nwords; w++) {
+                unsigned long v = gen[b * nwords + w] | (o[w] & ~kill[b * nwords + w]);
+                if (v != in[b * nwords + w]) {
+                    in[b * nwords + w] = v;
+                    changed = true;
+                }
+            }
+        }
+    }
+
+    // 入口で生きていればブロックの先頭から，出口で生きていればブロックの末尾まで広げる
+    int *reg_of = calloc(nglobals, sizeof(int));
+    for (int r = 1; r < f->nregs; r++)
+        if (global[r] >= 0)
+            reg_of[global[r]] = r;
+
+    for (int b = 0; b < f->nbbs; b++) {
+        for (int i = 0; i < nglobals; i++) {
+            Interval *x = &iv[reg_of[i]];
+            unsigned long bit = 1ul << (i % 64);
+            if ((in[b * nwords + i / 64] & bit) && x->start > bb_start[b])
+                x->start = bb_start[b];
+            if ((out[b * nwords + i / 64] & bit) && x->end < bb_end[b])
+                x->end = bb_end[b];
+        }
+    }
+
+    free(reg_of);
+    free(gen);
+    free(kill);
+    free(in);
+    free(out);
+}
+
+// スピルしたレジスタに次の領域を割り当てる
+static void spill(IrFunc *f, Interval *x) {
+    f->loc[x->reg] = -++f->nspills;
+}
+
+void alloc_regs(IrFunc *f) {
+    f->loc = arena_alloc(f->arena, sizeof(int) * f->nregs);
+    f->nspills = 0;
+    f->used_regs = 0;
+
+    BB **bbs = calloc(f->nbbs, sizeof(BB *));
+    int *bb_start = calloc(f->nbbs, sizeof(int));
+    int *bb_end = calloc(f->nbbs, sizeof(int));
+    int *def_bb = calloc(f->nregs, sizeof(int));
+    Interval *iv = calloc(f->nregs, sizeof(Interval));
+
+    // 命令に通し番号を振り，各レジスタの定義と最後の使用の位置を求める
+    int ninsns = 0;
+    for (BB *bb = f->bbs; bb; bb = bb->next)
+        for (Ir *ir = bb->first; ir; ir = ir->next)
+            ninsns++;
+
+    // calls[p]は位置p以前にある関数呼び出しの数．呼び出しは位置2i+1にあるとみなす
+    int *calls = calloc(ninsns * 2 + 1, sizeof(int));
+
+    int pos = 0;
+    for (BB *bb = f->bbs; bb; bb = bb->next) {
+        bbs[bb->label] = bb;
+        bb_start[bb->label] = pos * 2;
+        for (Ir *ir = bb->first; ir; ir = ir->next, pos++) {
+            int *regs;
+            int nuses = ir_uses(ir, &regs);
+            for (int i = 0; i < nuses; i++)
+                if (iv[regs[i]].end < pos * 2)
+                    iv[regs[i]].end = pos * 2;
+            if (ir_defines(ir)) {
+                // 変数のレジスタは何度も定義されるので，区間は最初の定義から始まる
+                Interval *x = &iv[ir->d];
+                if (!def_bb[ir->d])
+                    x->start = pos * 2 + 1;
+                if (x->end < pos * 2 + 1)
+                    x->end = pos * 2 + 1;
+                def_bb[ir->d] = bb->label + 1;
+            }
+            if (ir->op == IR_CALL)
+                calls[pos * 2 + 1] = 1;
+        }
+        bb_end[bb->label] = pos * 2;
+    }
+    for (int p = 1; p <= ninsns * 2; p++)
+        calls[p] += calls[p - 1];
+
+    // 定義と別のブロックで使うか，定義より前で使うレジスタはブロックをまたぐ．
+    // 変数のレジスタは定義が1か所とは限らないので，使っていればまたぐものとして扱う
+    int *global = malloc(sizeof(int) * f->nregs);
+    int nglobals = 0;
+    for (int r = 0; r < f->nregs; r++)
+        global[r] = -1;
+    pos = 0;
+    for (BB *bb = f->bbs; bb; bb = bb->next) {
+        for (Ir *ir = bb->first; ir; ir = ir->next, pos++) {
+            int *regs;
+            int nuses = ir_uses(ir, &regs);
+            for (int i = 0; i < nuses; i++) {
+                int r = regs[i];
+                bool is_var = f->reg_var && f->reg_var[r];
+                if (global[r] < 0 && (is_var || def_bb[r] != bb->label + 1 || iv[r].start > pos * 2))
+                    global[r] = nglobals++;
+            }
+        }
+    }
+    if (nglobals)
+        extend_global(f, bbs, bb_start, bb_end, global, nglobals, iv);
+
+    Interval **order = malloc(sizeof(Interval *) * f->nregs);
+    int n = 0;
+    for (int r = 1; r < f->nregs; r++) {
+        // 他の最適化で消えたレジスタは割り当てない
+        if (!def_bb[r] && global[r] < 0)
+            continue;
+        Interval *x = &iv[r];
+        x->reg = r;
+        x->across_call = x->end > x->start && calls[x->end - 1] - calls[x->start] > 0;
+        order[n++] = x;
+    }
+    qsort(order, n, sizeof(Interval *), compare_start);
+
+    // active[p]は物理レジスタpをいま使っている区間
+    Interval *active[NUM_REGS] = {};
+    for (int i = 0; i < n; i++) {
+        Interval *cur = order[i];
+        for (int p = 0; p < NUM_REGS; p++)
+            if (active[p] && active[p]->end < cur->start)
+                active[p] = NULL;
+
+        // 呼び出しをまたがなければ，保存の要らない呼び出し元保存のレジスタから使う
+        int lo = cur->across_call ? NUM_CALLER_SAVED : 0;
+        int p = lo;
+        while (p < NUM_REGS && active[p])
+            p++;
+
+        if (p == NUM_REGS) {
+            // 終点がいちばん遠い区間をスピルする
+            int victim = lo;
+            for (int q = lo; q < NUM_REGS; q++)
+                if (active[q]->end > active[victim]->end)
+                    victim = q;
+            if (active[victim]->end <= cur->end) {
+                spill(f, cur);
+                continue;
+            }
+            spill(f, active[victim]);
+            p = victim;
+        }
+
+        f->loc[cur->reg] = p;
+        f->used_regs |= 1u << p;
+        active[p] = cur;
+    }
+
+    free(bbs);
+    free(bb_start);
+    free(bb_end);
+    free(def_bb);
+    free(iv);
+    free(calls);
+    free(global);
+    free(order);
+}
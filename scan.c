@@ -0,0 +1,221 @@
+#include "gencc.h"
+
+// 走査カーネルは最適化しないと逐次版より遅くなるので，
+// ビルド全体の設定にかかわらずこのファイルだけは最適化する．
+#pragma GCC optimize("O2")
+
+// トークナイザが使う走査カーネル．
+//
+// 空白，識別子，数字の連続や，コメントの本体をまとめて読み飛ばす．
+// x86-64ではSSE2/AVX2で16〜32バイトずつ調べ，それ以外では1バイトずつ調べる．
+// どの実装を使うかはinit_scanで実行時に選ぶ．
+//
+// SIMD版はアラインされた位置から読み込むので，文字列の終端'\0'より後ろを
+// 最大31バイト読むことがある．アラインされた読み込みはページ境界をまたがないので，
+// 終端を含むページの外に触れることはない．
+
+static bool is_space(char c) {
+    return c == ' ' || ('\t' <= c && c <= '\r');
+}
+
+static bool is_digit(char c) {
+    return '0' <= c && c <= '9';
+}
+
+static bool is_ident(char c) {
+    return ('a' <= c && c <= 'z') || ('A' <= c && c <= 'Z') || is_digit(c) || c == '_';
+}
+
+static char *skip_space_scalar(char *p) {
+    while (is_space(*p))
+        p++;
+    return p;
+}
+
+static char *skip_ident_scalar(char *p) {
+    while (is_ident(*p))
+        p++;
+    return p;
+}
+
+static char *skip_digit_scalar(char *p) {
+    while (is_digit(*p))
+        p++;
+    return p;
+}
+
+static char *skip_line_scalar(char *p) {
+    while (*p != '\n' && *p != '\0')
+        p++;
+    return p;
+}
+
+static char *find_comment_end_scalar(char *p) {
+    for (; *p; p++)
+        if (p[0] == '*' && p[1] == '/')
+            return p;
+    return NULL;
+}
+
+#ifdef __x86_64__
+#include<immintrin.h>
+
+// vの各バイトがlo以上hi以下かどうか．0x80以降のバイトは負数になるので範囲外になる．
+#define IN_RANGE128(v, lo, hi) \
+    _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8((lo) - 1)), \
+                  _mm_cmplt_epi8(v, _mm_set1_epi8((hi) + 1)))
+
+#define IN_RANGE256(v, lo, hi) \
+    _mm256_and_si256(_mm256_cmpgt_epi8(v, _mm256_set1_epi8((lo) - 1)), \
+                     _mm256_cmpgt_epi8(_mm256_set1_epi8((hi) + 1), v))
+
+static unsigned space_mask128(__m128i v) {
+    __m128i m = _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(' ')), IN_RANGE128(v, '\t', '\r'));
+    return _mm_movemask_epi8(m);
+}
+
+static unsigned ident_mask128(__m128i v) {
+    __m128i lower = _mm_or_si128(v, _mm_set1_epi8(0x20));
+    __m128i m = _mm_or_si128(IN_RANGE128(lower, 'a', 'z'), IN_RANGE128(v, '0', '9'));
+    m = _mm_or_si128(m, _mm_cmpeq_epi8(v, _mm_set1_epi8('_')));
+    return _mm_movemask_epi8(m);
+}
+
+static unsigned digit_mask128(__m128i v) {
+    return _mm_movemask_epi8(IN_RANGE128(v, '0', '9'));
+}
+
+static unsigned eol_mask128(__m128i v) {
+    __m128i m = _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('\n')), _mm_cmpeq_epi8(v, _mm_setzero_si128()));
+    return _mm_movemask_epi8(m);
+}
+
+#define AVX2 __attribute__((target("avx2")))
+
+AVX2 static unsigned space_mask256(__m256i v) {
+    __m256i m = _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(' ')), IN_RANGE256(v, '\t', '\r'));
+    return _mm256_movemask_epi8(m);
+}
+
+AVX2 static unsigned ident_mask256(__m256i v) {
+    __m256i lower = _mm256_or_si256(v, _mm256_set1_epi8(0x20));
+    __m256i m = _mm256_or_si256(IN_RANGE256(lower, 'a', 'z'), IN_RANGE256(v, '0', '9'));
+    m = _mm256_or_si256(m, _mm256_cmpeq_epi8(v, _mm256_set1_epi8('_')));
+    return _mm256_movemask_epi8(m);
+}
+
+AVX2 static unsigned digit_mask256(__m256i v) {
+    return _mm256_movemask_epi8(IN_RANGE256(v, '0', '9'));
+}
+
+AVX2 static unsigned eol_mask256(__m256i v) {
+    __m256i m = _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('\n')),
+                                _mm256_cmpeq_epi8(v, _mm256_setzero_si256()));
+    return _mm256_movemask_epi8(m);
+}
+
+// maskfnの結果をinvと排他的論理和したビットが立つ最初のバイトを返す関数を定義する．
+// inv = 0なら「その文字が現れるまで」，inv = 全ビットなら「その文字が続く間」読み飛ばす．
+#define DEFINE_SCAN128(name, maskfn, inv) \
+    static char *name(char *p) { \
+        unsigned long off = (unsigned long)p & 15; \
+        char *q = p - off; \
+        unsigned m = (maskfn(_mm_load_si128((__m128i *)q)) ^ (inv)) & (0xFFFFu << off); \
+        while (!m) { \
+            q += 16; \
+            m = maskfn(_mm_load_si128((__m128i *)q)) ^ (inv); \
+        } \
+        return q + __builtin_ctz(m); \
+    }
+
+#define DEFINE_SCAN256(name, maskfn, inv) \
+    AVX2 static char *name(char *p) { \
+        unsigned long off = (unsigned long)p & 31; \
+        char *q = p - off; \
+        unsigned m = (maskfn(_mm256_load_si256((__m256i *)q)) ^ (inv)) & (0xFFFFFFFFu << off); \
+        while (!m) { \
+            q += 32; \
+            m = maskfn(_mm256_load_si256((__m256i *)q)) ^ (inv); \
+        } \
+        return q + __builtin_ctz(m); \
+    }
+
+DEFINE_SCAN128(skip_space_sse2, space_mask128, 0xFFFFu)
+DEFINE_SCAN128(skip_ident_sse2, ident_mask128, 0xFFFFu)
+DEFINE_SCAN128(skip_digit_sse2, digit_mask128, 0xFFFFu)
+DEFINE_SCAN128(skip_line_sse2, eol_mask128, 0)
+
+DEFINE_SCAN256(skip_space_avx2, space_mask256, 0xFFFFFFFFu)
+DEFINE_SCAN256(skip_ident_avx2, ident_mask256, 0xFFFFFFFFu)
+DEFINE_SCAN256(skip_digit_avx2, digit_mask256, 0xFFFFFFFFu)
+DEFINE_SCAN256(skip_line_avx2, eol_mask256, 0)
+
+// "*/"の'*'の位置か，'\0'の位置を返す関数を定義する．
+// '*'のマスクと，1バイトずらした'/'のマスクの論理積で"*/"を探す．
+// ブロックの最後のバイトが'*'のときは，次のブロックの先頭を1バイトだけ見る．
+// ブロック内に'\0'がなければ，次のブロックも文字列の内側にあるので読んでよい．
+#define DEFINE_FIND_COMMENT_END(name, attr, vec, width, full, load, cmpeq, set1, zero, movemask) \
+    attr static char *name(char *p) { \
+        unsigned long off = (unsigned long)p & (width - 1); \
+        char *q = p - off; \
+        unsigned valid = full << off; \
+        for (;;) { \
+            vec v = load((vec *)q); \
+            unsigned star = movemask(cmpeq(v, set1('*'))); \
+            unsigned slash = movemask(cmpeq(v, set1('/'))); \
+            unsigned nul = movemask(cmpeq(v, zero())) & valid; \
+            unsigned m = (star & (slash >> 1)) & valid; \
+            if (!nul && (star >> (width - 1)) && q[width] == '/') \
+                m |= 1u << (width - 1); \
+            m |= nul; \
+            if (m) { \
+                char *r = q + __builtin_ctz(m); \
+                return *r ? r : NULL; \
+            } \
+            q += width; \
+            valid = full; \
+        } \
+    }
+
+DEFINE_FIND_COMMENT_END(find_comment_end_sse2, , __m128i, 16, 0xFFFFu, _mm_load_si128,
+                        _mm_cmpeq_epi8, _mm_set1_epi8, _mm_setzero_si128, _mm_movemask_epi8)
+DEFINE_FIND_COMMENT_END(find_comment_end_avx2, AVX2, __m256i, 32, 0xFFFFFFFFu, _mm256_load_si256,
+                        _mm256_cmpeq_epi8, _mm256_set1_epi8, _mm256_setzero_si256, _mm256_movemask_epi8)
+
+#undef DEFINE_SCAN128
+#undef DEFINE_SCAN256
+#undef DEFINE_FIND_COMMENT_END
+#endif
+
+char *(*skip_space)(char *p) = skip_space_scalar;
+char *(*skip_ident)(char *p) = skip_ident_scalar;
+char *(*skip_digit)(char *p) = skip_digit_scalar;
+char *(*skip_line)(char *p) = skip_line_scalar;
+char *(*find_comment_end)(char *p) = find_comment_end_scalar;
+
+// CPUの機能を調べて走査カーネルを選ぶ．
+// 環境変数GENCC_SCANにscalarかsse2を指定すると，その実装に固定できる．
+void init_scan() {
+    char *force = getenv("GENCC_SCAN");
+    if (force && !strcmp(force, "scalar"))
+        return;
+
+#ifdef __x86_64__
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2") && !(force && !strcmp(force, "sse2"))) {
+        skip_space = skip_space_avx2;
+        skip_ident = skip_ident_avx2;
+        skip_digit = skip_digit_avx2;
+        skip_line = skip_line_avx2;
+        find_comment_end = find_comment_end_avx2;
+        return;
+    }
+
+    // SSE2はx86-64では必ず使える
+    skip_space = skip_space_sse2;
+    skip_ident = skip_ident_sse2;
+    skip_digit = skip_digit_sse2;
+    skip_line = skip_line_sse2;
+    find_comment_end = find_comment_end_sse2;
+#endif
+}
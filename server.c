@@ -0,0 +1,295 @@
+#include "gencc.h"
+
+// コンパイルサーバとそのクライアント．
+//
+// サーバはUnixドメインソケットで待ち受け，ファイルのパスを受け取って
+// アセンブリを返す．ワーカーはそれぞれContextを1つ持ち続け，
+// アリーナのチャンクや各種の表をジョブの間で使い回す．関数のコード生成には，
+// 起動時に作ったスレッドプールをすべてのジョブで使い回す．
+//
+// クライアントは通常のコマンドラインと同じように振る舞い，
+// コンパイルだけをサーバに任せる．1つの接続で複数のファイルを順に送れる．
+// コンパイルのオプションとキャッシュはサーバを起動したときのものを使うので，
+// 出力を変えるオプションや統計を表示するオプションはクライアントでは受け付けない．
+//
+// 同じマシン上の通信なので，ヘッダはネイティブのバイト順で送る．
+
+// 大きすぎる要求は壊れているとみなす
+#define MAX_NAME_LEN (1 << 16)
+#define MAX_SRC_LEN (1L << 30)
+
+// 要求．この後にファイル名，パス，ソースが続く
+typedef struct {
+    int namelen;  // 診断メッセージに表示するファイル名の長さ
+    int pathlen;  // サーバが読み込むファイルの絶対パスの長さ．0ならソースを送る
+    long srclen;  // ソースの長さ
+} Request;
+
+// 応答．この後にアセンブリと診断メッセージが続く
+typedef struct {
+    int status;   // 成功なら0
+    long outlen;  // アセンブリの長さ
+    long errlen;  // 診断メッセージの長さ
+} Response;
+
+// lenバイトを読み込む．途中で接続が切れたら偽を返す．
+static bool read_full(int fd, void *buf, long len) {
+    char *p = buf;
+    while (len > 0) {
+        ssize_t n = read(fd, p, len);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            return false;
+        p += n;
+        len -= n;
+    }
+    return true;
+}
+
+static bool write_full(int fd, void *buf, long len) {
+    char *p = buf;
+    while (len > 0) {
+        ssize_t n = write(fd, p, len);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n < 0)
+            return false;
+        p += n;
+        len -= n;
+    }
+    return true;
+}
+
+// lenバイトを読み込んで'\0'で終わる文字列にする
+static char *read_string(int fd, long len) {
+    char *s = malloc(len + 1);
+    if (!read_full(fd, s, len)) {
+        free(s);
+        return NULL;
+    }
+    s[len] = '\0';
+    return s;
+}
+
+// ソースを読み込む．read_fileと同じく末尾に"\n\0"が続くようにする．
+static char *read_source(int fd, long len) {
+    char *s = malloc(len + 2);
+    if (!read_full(fd, s, len)) {
+        free(s);
+        return NULL;
+    }
+    if (len == 0 || s[len - 1] != '\n')
+        s[len++] = '\n';
+    s[len] = '\0';
+    return s;
+}
+
+static int unix_socket(char *sockpath, struct sockaddr_un *addr) {
+    if (strlen(sockpath) >= sizeof(addr->sun_path))
+        error("%s: socket path too long", sockpath);
+
+    memset(addr, 0, sizeof(*addr));
+    addr->sun_family = AF_UNIX;
+    strcpy(addr->sun_path, sockpath);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0)
+        error("cannot create a socket: %s", strerror(errno));
+    return fd;
+}
+
+//
+// サーバ
+//
+
+// 1つの要求を処理する．関数のコード生成はpoolで並列に行う．接続が切れたら偽を返す．
+static bool serve_request(Context *c, int conn, ThreadPool *pool) {
+    Request req;
+    if (!read_full(conn, &req, sizeof(req)))
+        return false;
+    if (req.namelen < 0 || req.namelen > MAX_NAME_LEN ||
+        req.pathlen < 0 || req.pathlen > MAX_NAME_LEN ||
+        req.srclen < 0 || req.srclen > MAX_SRC_LEN)
+        return false;
+
+    char *name = read_string(conn, req.namelen);
+    char *path = name ? read_string(conn, req.pathlen) : NULL;
+    char *src = NULL;
+    if (path && !req.pathlen)
+        src = read_source(conn, req.srclen);
+    if (!path || (!req.pathlen && !src)) {
+        free(name);
+        free(path);
+        return false;
+    }
+
+    // 診断メッセージはメモリに溜めてクライアントに返す
+    char *errbuf = NULL;
+    size_t errlen = 0;
+    c->filename = name;
+    c->user_input = src;
+    c->errout = open_memstream(&errbuf, &errlen);
+
+    Buffer *out = new_buffer(-1);
+    bool ok = compile(c, path, out, pool);
+    fclose(c->errout);
+
+    Response res;
+    res.status = ok ? 0 : 1;
+    res.outlen = ok ? out->len : 0;
+    res.errlen = errlen;
+    bool sent = write_full(conn, &res, sizeof(res)) &&
+                write_full(conn, out->data, res.outlen) &&
+                write_full(conn, errbuf, res.errlen);
+
+    free_buffer(out);
+    free(errbuf);
+    reset_context(c);
+    free(name);
+    free(path);
+    return sent;
+}
+
+typedef struct {
+    int sock;
+    ThreadPool *codegen;    // ジョブの間で使い回すコード生成のプール
+} Server;
+
+// ワーカー．接続を受け付けては，切れるまで要求を処理する．
+static void serve_job(void *arg, long i) {
+    Server *srv = arg;
+    int sock = srv->sock;
+    Context *c = new_context();
+
+    for (;;) {
+        int conn = accept(sock, NULL, NULL);
+        if (conn < 0) {
+            if (errno == EINTR || errno == ECONNABORTED)
+                continue;
+            error("accept failed: %s", strerror(errno));
+        }
+        while (serve_request(c, conn, srv->codegen))
+            ;
+        close(conn);
+    }
+}
+
+// sockpathで待ち受けて，CPUの数だけのワーカーで要求を処理し続ける．
+// 関数のコード生成には，起動時に作ったnthreads個のスレッドのプールを使い続ける．
+// nthreadsが0以下ならCPUの数だけ使う．
+void run_server(char *sockpath, int nthreads) {
+    // クライアントが途中で切断してもサーバは止めない
+    signal(SIGPIPE, SIG_IGN);
+
+    struct sockaddr_un addr;
+    int sock = unix_socket(sockpath, &addr);
+
+    // 前のサーバが残したソケットだけを消す．ソースファイルなどを誤って消さないように，
+    // ソケット以外のファイルがあれば起動しない
+    struct stat st;
+    if (!lstat(sockpath, &st)) {
+        if (!S_ISSOCK(st.st_mode))
+            error("cannot bind %s: file exists", sockpath);
+        unlink(sockpath);
+    }
+    if (bind(sock, (struct sockaddr *)&addr, sizeof(addr)))
+        error("cannot bind %s: %s", sockpath, strerror(errno));
+    if (listen(sock, 64))
+        error("cannot listen on %s: %s", sockpath, strerror(errno));
+
+    // コード生成のプールは一度に1つの要求しか使えないので，
+    // 使われている間の要求は自分のスレッドだけで生成する
+    Server srv = { .sock = sock, .codegen = new_pool(nthreads) };
+    ThreadPool *workers = new_pool(0);
+    pool_run(workers, pool_size(workers), serve_job, &srv);
+}
+
+//
+// クライアント
+//
+
+// fileをサーバでコンパイルして，成功したらアセンブリをoutpathに書き出す．
+// outpathがNULLか"-"なら標準出力に書く．
+static bool remote_compile(int sock, char *file, char *outpath) {
+    Request req = {};
+    char *path = NULL;
+    char *src = NULL;
+    long maplen = 0;
+
+    // 標準入力はサーバから読めないので内容を送る
+    if (!strcmp(file, "-")) {
+        src = read_file(file, &maplen);
+        req.srclen = strlen(src);
+    } else {
+        path = realpath(file, NULL);
+        if (!path) {
+            fprintf(stderr, "cannot open %s: %s\n", file, strerror(errno));
+            return false;
+        }
+        req.pathlen = strlen(path);
+    }
+    req.namelen = strlen(file);
+
+    if (!write_full(sock, &req, sizeof(req)) ||
+        !write_full(sock, file, req.namelen) ||
+        !write_full(sock, path, req.pathlen) ||
+        !write_full(sock, src, req.srclen))
+        error("lost connection to the server");
+    free(path);
+    free(src);
+
+    Response res;
+    if (!read_full(sock, &res, sizeof(res)))
+        error("lost connection to the server");
+    char *asm_text = malloc(res.outlen + 1);
+    char *diag = malloc(res.errlen + 1);
+    if (!read_full(sock, asm_text, res.outlen) || !read_full(sock, diag, res.errlen))
+        error("lost connection to the server");
+
+    write_full(STDERR_FILENO, diag, res.errlen);
+    free(diag);
+
+    // 出力先は成功してから開くので，失敗しても前の出力は残る
+    bool ok = res.status == 0;
+    if (ok) {
+        OutFile *of = open_output(outpath);
+        if (!of)
+            error("cannot open %s: %s", outpath, strerror(errno));
+        Buffer *buf = new_buffer(of->fd);
+        buf_write(buf, asm_text, res.outlen);
+        buf_flush(buf);
+        free_buffer(buf);
+        if (!close_output(of, true))
+            error("cannot write %s: %s", outpath, strerror(errno));
+    }
+    free(asm_text);
+    return ok;
+}
+
+// サーバに接続してfilesをコンパイルする．コマンドラインと同じく，
+// 1つなら標準出力かoutpathに，複数ならそれぞれ対応する.sファイルに書き出す．
+// 終了ステータスを返す．
+int run_client(char *sockpath, char **files, long nfiles, char *outpath) {
+    if (nfiles > 1 && outpath)
+        error("cannot specify -o with multiple files");
+
+    struct sockaddr_un addr;
+    int sock = unix_socket(sockpath, &addr);
+    if (connect(sock, (struct sockaddr *)&addr, sizeof(addr)))
+        error("cannot connect to %s: %s", sockpath, strerror(errno));
+
+    bool ok = true;
+    if (nfiles == 1) {
+        ok = remote_compile(sock, files[0], outpath);
+    } else {
+        for (long i = 0; i < nfiles; i++) {
+            char *out = asm_path(files[i]);
+            ok = remote_compile(sock, files[i], out) && ok;
+            free(out);
+        }
+    }
+
+    close(sock);
+    return ok ? 0 : 1;
+}
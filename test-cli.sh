@@ -0,0 +1,106 @@
+#!/bin/bash
+# コマンドラインの各モードでtestsをコンパイルし，普通にコンパイルした結果と比べる．
+
+GENCC=$(realpath ./gencc)
+TMP=$(mktemp -d)
+trap 'kill $server 2>/dev/null; rm -rf $TMP' EXIT
+
+fail() {
+    echo "FAIL: $1"
+    exit 1
+}
+
+# 期待する出力$1と$2が同じことを確かめる
+check() {
+    cmp -s "$1" "$2" || fail "$3: $2 differs from $1"
+    echo "$3 => ok"
+}
+
+# --cache-statsの出力$1に$2が含まれることを確かめる
+check_stats() {
+    grep -q "$2" "$1" || fail "$3: expected '$2', got '$(cat "$1")'"
+    echo "$3 => ok"
+}
+
+$GENCC tests > $TMP/expected.s || fail "plain compile"
+cp tests $TMP/a.c
+cp tests $TMP/b.c
+
+# -oと標準入力
+$GENCC -o $TMP/out.s tests || fail "-o"
+check $TMP/expected.s $TMP/out.s "-o"
+$GENCC - < tests > $TMP/stdin.s || fail "stdin"
+check $TMP/expected.s $TMP/stdin.s "stdin"
+
+# 失敗したコンパイルは-oの前の出力を残す
+echo 'int main() { return 1 }' > $TMP/bad.c
+$GENCC -o $TMP/out.s $TMP/bad.c 2> /dev/null && fail "-o with an error succeeded"
+check $TMP/expected.s $TMP/out.s "-o keeps the old output on error"
+
+# 関数の並列生成と，複数ファイルの並列コンパイル
+$GENCC -j4 benchmark > $TMP/bench-j4.s || fail "-j4"
+$GENCC -j1 benchmark > $TMP/bench-j1.s || fail "-j1"
+check $TMP/bench-j1.s $TMP/bench-j4.s "-j4"
+$GENCC -j2 $TMP/a.c $TMP/b.c || fail "multiple files"
+check $TMP/expected.s $TMP/a.s "multiple files (a.s)"
+check $TMP/expected.s $TMP/b.s "multiple files (b.s)"
+rm $TMP/a.s $TMP/b.s
+printf '%s\n%s\n' $TMP/a.c $TMP/b.c > $TMP/files.rsp
+$GENCC @$TMP/files.rsp || fail "@response"
+check $TMP/expected.s $TMP/a.s "@response (a.s)"
+check $TMP/expected.s $TMP/b.s "@response (b.s)"
+rm $TMP/a.s $TMP/b.s
+
+# コンパイルサーバ
+$GENCC --server $TMP/sock -j2 &
+server=$!
+for i in $(seq 50); do
+    [ -S $TMP/sock ] && break
+    sleep 0.1
+done
+[ -S $TMP/sock ] || fail "--server did not start"
+$GENCC --connect $TMP/sock tests > $TMP/remote.s || fail "--connect"
+check $TMP/expected.s $TMP/remote.s "--connect"
+$GENCC --connect $TMP/sock -o $TMP/remote-o.s tests || fail "--connect -o"
+check $TMP/expected.s $TMP/remote-o.s "--connect -o"
+$GENCC --connect $TMP/sock - < tests > $TMP/remote-stdin.s || fail "--connect stdin"
+check $TMP/expected.s $TMP/remote-stdin.s "--connect stdin"
+$GENCC --connect $TMP/sock $TMP/a.c $TMP/b.c || fail "--connect multiple files"
+check $TMP/expected.s $TMP/a.s "--connect multiple files (a.s)"
+check $TMP/expected.s $TMP/b.s "--connect multiple files (b.s)"
+$GENCC --connect $TMP/sock -o $TMP/remote-o.s $TMP/bad.c 2> /dev/null && fail "--connect with an error succeeded"
+check $TMP/expected.s $TMP/remote-o.s "--connect -o keeps the old output on error"
+kill $server
+wait $server 2> /dev/null
+server=
+
+# キャッシュの失敗，命中，追い出し
+CACHE="--cache-dir $TMP/cache --cache-stats"
+$GENCC $CACHE tests > $TMP/cache1.s 2> $TMP/stats || fail "cache miss"
+check $TMP/expected.s $TMP/cache1.s "cache miss"
+check_stats $TMP/stats "0 hits, 1 misses, 1 stores" "cache miss stats"
+$GENCC $CACHE tests > $TMP/cache2.s 2> $TMP/stats || fail "cache hit"
+check $TMP/expected.s $TMP/cache2.s "cache hit"
+check_stats $TMP/stats "1 hits, 0 misses, 0 stores" "cache hit stats"
+# キャッシュは256個のサブディレクトリに分かれているので，257個の結果を保存すれば
+# どこかのサブディレクトリに2つ入り，1つあたりの上限を超えたほうが追い出される
+mkdir $TMP/evict
+for i in $(seq 257); do
+    echo "int main() { return $i; }" > $TMP/evict/$i.c
+done
+$GENCC --cache-dir $TMP/evict-cache --cache-stats --cache-size 1K $TMP/evict/*.c 2> $TMP/stats || fail "cache eviction"
+check_stats $TMP/stats "257 stores" "cache eviction stores"
+grep -q " 0 evictions" $TMP/stats && fail "cache eviction: nothing evicted: $(cat $TMP/stats)"
+echo "cache eviction => ok"
+
+# 増分コンパイルでは，変更した関数だけを生成し直す
+cp benchmark $TMP/inc.c
+$GENCC $CACHE --incremental $TMP/inc.c > /dev/null 2> $TMP/stats || fail "incremental"
+check_stats $TMP/stats "0 functions reused, 6 recompiled" "incremental first compile"
+sed -i 's/^int fib(int n) {/int fib(int n) {\n    n = n + 0;/' $TMP/inc.c
+$GENCC $TMP/inc.c > $TMP/inc-expected.s || fail "incremental"
+$GENCC $CACHE --incremental $TMP/inc.c > $TMP/inc.s 2> $TMP/stats || fail "incremental"
+check $TMP/inc-expected.s $TMP/inc.s "incremental after an edit"
+check_stats $TMP/stats "5 functions reused, 1 recompiled" "incremental reuse stats"
+
+echo OK
@@ -0,0 +1,2290 @@
+.intel_syntax noprefix
+.text
+.global assert
+assert:
+    push rbp
+    mov rbp, rsp
+    sub rsp, 32
+    mov [rbp-8], rbx
+    mov [rbp-16], r12
+    mov [rbp-24], r13
+.Lbb.assert.0:
+    mov rbx, rdi
+    mov r12, rsi
+    mov r13, rdx
+    cmp rbx, r12
+    jne .Lbb.assert.2
+.Lbb.assert.1:
+    mov r10, offset .L.data.0
+    mov rdi, r10
+    mov rsi, r13
+    mov rdx, r12
+    mov rax, 0
+    call printf
+    jmp .Lbb.assert.3
+.Lbb.assert.2:
+    mov r10, offset .L.data.1
+    mov rdi, r10
+    mov rsi, r13
+    mov rdx, rbx
+    mov rcx, r12
+    mov rax, 0
+    call printf
+    mov rdi, 1
+    mov rax, 0
+    call exit
+.Lbb.assert.3:
+.Lreturn.assert:
+    mov rbx, [rbp-8]
+    mov r12, [rbp-16]
+    mov r13, [rbp-24]
+    mov rsp, rbp
+    pop rbp
+    ret
+.global ret3
+ret3:
+    push rbp
+    mov rbp, rsp
+    sub rsp, 0
+.Lbb.ret3.0:
+    mov rax, 3
+    jmp .Lreturn.ret3
+.Lbb.ret3.1:
+    mov rax, 5
+.Lreturn.ret3:
+    mov rsp, rbp
+    pop rbp
+    ret
+.global add2
+add2:
+    push rbp
+    mov rbp, rsp
+    sub rsp, 0
+.Lbb.add2.0:
+    mov r10, rdi
+    mov r11, rsi
+    add r10, r11
+    mov rax, r10
+.Lreturn.add2:
+    mov rsp, rbp
+    pop rbp
+    ret
+.global sub2
+sub2:
+    push rbp
+    mov rbp, rsp
+    sub rsp, 0
+.Lbb.sub2.0:
+    mov r10, rdi
+    mov r11, rsi
+    sub r10, r11
+    mov rax, r10
+.Lreturn.sub2:
+    mov rsp, rbp
+    pop rbp
+    ret
+.global add6
+add6:
+    push rbp
+    mov rbp, rsp
+    sub rsp, 32
+    mov [rbp-8], rbx
+    mov [rbp-16], r12
+    mov [rbp-24], r13
+    mov [rbp-32], r14
+.Lbb.add6.0:
+    mov r10, rdi
+    mov r11, rsi
+    mov rbx, rdx
+    mov r12, rcx
+    mov r13, r8
+    mov r14, r9
+    add r10, r11
+    add r10, rbx
+    add r10, r12
+    add r10, r13
+    add r10, r14
+    mov rax, r10
+.Lreturn.add6:
+    mov rbx, [rbp-8]
+    mov r12, [rbp-16]
+    mov r13, [rbp-24]
+    mov r14, [rbp-32]
+    mov rsp, rbp
+    pop rbp
+    ret
+.global addx
+addx:
+    push rbp
+    mov rbp, rsp
+    sub rsp, 0
+.Lbb.addx.0:
+    mov r10, rdi
+    mov r11, rsi
+    mov r10, [r10]
+    add r10, r11
+    mov rax, r10
+.Lreturn.addx:
+    mov rsp, rbp
+    pop rbp
+    ret
+.global sub_char
+sub_char:
+    push rbp
+    mov rbp, rsp
+    sub rsp, 16
+.Lbb.sub_char.0:
+    mov byte ptr [rbp-3], dil
+    mov byte ptr [rbp-2], sil
+    mov byte ptr [rbp-1], dl
+    movsx r10, byte ptr [rbp-3]
+    movsx r11, byte ptr [rbp-2]
+    sub r10, r11
+    movsx r11, byte ptr [rbp-1]
+    sub r10, r11
+    mov rax, r10
+.Lreturn.sub_char:
+    mov rsp, rbp
+    pop rbp
+    ret
+.global fib
+fib:
+    push rbp
+    mov rbp, rsp
+    sub rsp, 16
+    mov [rbp-8], rbx
+    mov [rbp-16], r12
+.Lbb.fib.0:
+    mov rbx, rdi
+    cmp rbx, 1
+    jg .Lbb.fib.2
+.Lbb.fib.1:
+    mov rax, 1
+    jmp .Lreturn.fib
+.Lbb.fib.3:
+.Lbb.fib.2:
+    mov rax, rbx
+    sub rax, 1
+    mov r10, rax
+    mov rdi, r10
+    mov rax, 0
+    call fib
+    mov r12, rax
+    mov rax, rbx
+    sub rax, 2
+    mov r10, rax
+    mov rdi, r10
+    mov rax, 0
+    call fib
+    mov r10, rax
+    add r10, r12
+    mov rax, r10
+.Lreturn.fib:
+    mov rbx, [rbp-8]
+    mov r12, [rbp-16]
+    mov rsp, rbp
+    pop rbp
+    ret
+.global main
+main:
+    push rbp
+    mov rbp, rsp
+    sub rsp, 2800
+    mov [rbp-2765], rbx
+    mov [rbp-2773], r12
+    mov [rbp-2781], r13
+    mov [rbp-2789], r14
+    mov [rbp-2797], r15
+.Lbb.main.0:
+    mov qword ptr [rbp-2757], 3
+    mov qword ptr [rbp-2749], 5
+    mov r11, [rbp-2757]
+    mov rbx, [rbp-2749]
+    add r11, rbx
+    mov rbx, offset .L.data.2
+    mov rdi, 8
+    mov rsi, r11
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    mov r11, 4
+    mov qword ptr [rbp-2741], 3
+    mov rbx, [rbp-2741]
+    add rbx, 2
+    add r11, rbx
+    mov rbx, offset .L.data.3
+    mov rdi, 9
+    mov rsi, r11
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    mov rbx, offset .L.data.4
+    mov rdi, 0
+    mov rsi, 0
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    mov rbx, offset .L.data.5
+    mov rdi, 42
+    mov rsi, 42
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    mov rbx, offset .L.data.6
+    mov rdi, 5
+    mov rsi, 5
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    mov rbx, offset .L.data.7
+    mov rdi, 41
+    mov rsi, 41
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    mov rbx, offset .L.data.8
+    mov rdi, 5
+    mov rsi, 5
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    mov rbx, offset .L.data.9
+    mov rdi, 15
+    mov rsi, 15
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    mov rbx, offset .L.data.10
+    mov rdi, 4
+    mov rsi, 4
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    mov rbx, offset .L.data.11
+    mov rdi, -10
+    mov rsi, -10
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    mov rbx, offset .L.data.12
+    mov rdi, 10
+    mov rsi, 10
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    mov rbx, offset .L.data.13
+    mov rdi, 10
+    mov rsi, 10
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    mov rbx, offset .L.data.14
+    mov rdi, 7
+    mov rsi, 7
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    mov rbx, offset .L.data.15
+    mov rdi, 3
+    mov rsi, 3
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    mov rbx, offset .L.data.16
+    mov rdi, 0
+    mov rsi, 0
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    mov rbx, offset .L.data.17
+    mov rdi, 1
+    mov rsi, 1
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    mov rbx, offset .L.data.18
+    mov rdi, 1
+    mov rsi, 1
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    mov rbx, offset .L.data.19
+    mov rdi, 0
+    mov rsi, 0
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    mov rbx, offset .L.data.20
+    mov rdi, 1
+    mov rsi, 1
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    mov rbx, offset .L.data.21
+    mov rdi, 0
+    mov rsi, 0
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    mov rbx, offset .L.data.22
+    mov rdi, 0
+    mov rsi, 0
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    mov rbx, offset .L.data.23
+    mov rdi, 1
+    mov rsi, 1
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    mov rbx, offset .L.data.24
+    mov rdi, 1
+    mov rsi, 1
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    mov rbx, offset .L.data.25
+    mov rdi, 0
+    mov rsi, 0
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    mov rbx, offset .L.data.26
+    mov rdi, 1
+    mov rsi, 1
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    mov rbx, offset .L.data.27
+    mov rdi, 0
+    mov rsi, 0
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    mov rbx, offset .L.data.28
+    mov rdi, 0
+    mov rsi, 0
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    mov rbx, offset .L.data.29
+    mov rdi, 1
+    mov rsi, 1
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    mov rbx, offset .L.data.30
+    mov rdi, 1
+    mov rsi, 1
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    mov rbx, offset .L.data.31
+    mov rdi, 0
+    mov rsi, 0
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    mov qword ptr [rbp-2733], 3
+    mov r11, [rbp-2733]
+    mov rbx, offset .L.data.32
+    mov rdi, 3
+    mov rsi, r11
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    mov qword ptr [rbp-2725], 3
+    mov qword ptr [rbp-2717], 5
+    mov r11, [rbp-2725]
+    mov rbx, [rbp-2717]
+    add r11, rbx
+    mov rbx, offset .L.data.33
+    mov rdi, 8
+    mov rsi, r11
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    mov qword ptr [rbp-2709], 3
+    mov r11, [rbp-2709]
+    mov rbx, offset .L.data.34
+    mov rdi, 3
+    mov rsi, r11
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    mov qword ptr [rbp-2701], 3
+    mov qword ptr [rbp-2693], 5
+    mov r11, [rbp-2701]
+    mov rbx, [rbp-2693]
+    add r11, rbx
+    mov rbx, offset .L.data.35
+    mov rdi, 8
+    mov rsi, r11
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    mov qword ptr [rbp-2685], 3
+    mov r11, [rbp-2685]
+    mov rbx, offset .L.data.36
+    mov rdi, 3
+    mov rsi, r11
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    mov qword ptr [rbp-2677], 3
+    mov qword ptr [rbp-2669], 5
+    mov r11, [rbp-2677]
+    mov rbx, [rbp-2669]
+    add r11, rbx
+    mov rbx, offset .L.data.37
+    mov rdi, 8
+    mov rsi, r11
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    mov rbx, 3
+    mov rax, 0
+    call ret3
+    mov r10, rax
+    mov r11, offset .L.data.38
+    mov rdi, rbx
+    mov rsi, r10
+    mov rdx, r11
+    mov rax, 0
+    call assert
+    mov qword ptr [rbp-2661], 0
+    mov qword ptr [rbp-2661], 3
+    mov r11, [rbp-2661]
+    mov rbx, offset .L.data.39
+    mov rdi, 3
+    mov rsi, r11
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    mov qword ptr [rbp-2653], 0
+    mov qword ptr [rbp-2653], 3
+    mov r11, [rbp-2653]
+    mov rbx, offset .L.data.40
+    mov rdi, 3
+    mov rsi, r11
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    mov qword ptr [rbp-2645], 0
+    mov qword ptr [rbp-2645], 2
+    mov r11, [rbp-2645]
+    mov rbx, offset .L.data.41
+    mov rdi, 2
+    mov rsi, r11
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    mov qword ptr [rbp-2637], 0
+    mov qword ptr [rbp-2637], 2
+    mov r11, [rbp-2637]
+    mov rbx, offset .L.data.42
+    mov rdi, 2
+    mov rsi, r11
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    mov rbx, offset .L.data.43
+    mov rdi, 3
+    mov rsi, 3
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    mov r10, 10
+    mov qword ptr [rbp-2629], 0
+    mov qword ptr [rbp-2629], 0
+.Lbb.main.1:
+    mov r11, [rbp-2629]
+    cmp r11, 10
+    jge .Lbb.main.2
+.Lbb.main.3:
+    mov rbx, [rbp-2629]
+    add rbx, 1
+    mov [rbp-2629], rbx
+    jmp .Lbb.main.1
+.Lbb.main.2:
+    mov r11, [rbp-2629]
+    mov rbx, offset .L.data.44
+    mov rdi, r10
+    mov rsi, r11
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    mov r10, 55
+    mov qword ptr [rbp-2621], 0
+    mov qword ptr [rbp-2613], 0
+.Lbb.main.4:
+    mov r11, [rbp-2621]
+    cmp r11, 10
+    jg .Lbb.main.5
+.Lbb.main.6:
+    mov rbx, [rbp-2621]
+    mov r12, [rbp-2613]
+    add rbx, r12
+    mov [rbp-2613], rbx
+    mov rbx, [rbp-2621]
+    add rbx, 1
+    mov [rbp-2621], rbx
+    jmp .Lbb.main.4
+.Lbb.main.5:
+    mov r11, [rbp-2613]
+    mov rbx, offset .L.data.45
+    mov rdi, r10
+    mov rsi, r11
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    mov r10, 55
+    mov qword ptr [rbp-2605], 0
+    mov qword ptr [rbp-2597], 0
+    mov qword ptr [rbp-2605], 0
+.Lbb.main.7:
+    mov r11, [rbp-2605]
+    cmp r11, 10
+    jg .Lbb.main.8
+.Lbb.main.9:
+    mov rbx, [rbp-2605]
+    mov r12, [rbp-2597]
+    add rbx, r12
+    mov [rbp-2597], rbx
+    mov rbx, [rbp-2605]
+    add rbx, 1
+    mov [rbp-2605], rbx
+    jmp .Lbb.main.7
+.Lbb.main.8:
+    mov r11, [rbp-2597]
+    mov rbx, offset .L.data.46
+    mov rdi, r10
+    mov rsi, r11
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    mov qword ptr [rbp-2589], 0
+    mov qword ptr [rbp-2589], 2
+    mov r11, [rbp-2589]
+    mov rbx, offset .L.data.47
+    mov rdi, 2
+    mov rsi, r11
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    mov qword ptr [rbp-2581], 0
+    mov qword ptr [rbp-2581], 5
+    mov r11, [rbp-2581]
+    mov rbx, offset .L.data.48
+    mov rdi, 5
+    mov rsi, r11
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    mov qword ptr [rbp-2573], 3
+    mov r11, [rbp-2573]
+    add r11, 4
+    mov rbx, offset .L.data.49
+    mov rdi, 7
+    mov rsi, r11
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    mov rbx, 8
+    mov rdi, 3
+    mov rsi, 5
+    mov rax, 0
+    call add2
+    mov r10, rax
+    mov r11, offset .L.data.50
+    mov rdi, rbx
+    mov rsi, r10
+    mov rdx, r11
+    mov rax, 0
+    call assert
+    mov rbx, 2
+    mov rdi, 5
+    mov rsi, 3
+    mov rax, 0
+    call sub2
+    mov r10, rax
+    mov r11, offset .L.data.51
+    mov rdi, rbx
+    mov rsi, r10
+    mov rdx, r11
+    mov rax, 0
+    call assert
+    mov rbx, 21
+    mov rdi, 1
+    mov rsi, 2
+    mov rdx, 3
+    mov rcx, 4
+    mov r8, 5
+    mov r9, 6
+    mov rax, 0
+    call add6
+    mov r10, rax
+    mov r11, offset .L.data.52
+    mov rdi, rbx
+    mov rsi, r10
+    mov rdx, r11
+    mov rax, 0
+    call assert
+    mov rbx, 55
+    mov rdi, 9
+    mov rax, 0
+    call fib
+    mov r10, rax
+    mov r11, offset .L.data.53
+    mov rdi, rbx
+    mov rsi, r10
+    mov rdx, r11
+    mov rax, 0
+    call assert
+    mov qword ptr [rbp-2565], 3
+    mov r11, [rbp-2565]
+    mov rbx, offset .L.data.54
+    mov rdi, 3
+    mov rsi, r11
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    mov qword ptr [rbp-2557], 3
+    lea rbx, [rbp-2557]
+    mov [rbp-2549], rbx
+    lea rbx, [rbp-2549]
+    mov [rbp-2541], rbx
+    mov r11, rbx
+    mov r11, [r11]
+    mov r11, [r11]
+    mov rbx, offset .L.data.55
+    mov rdi, 3
+    mov rsi, r11
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    mov qword ptr [rbp-2533], 3
+    mov qword ptr [rbp-2525], 5
+    lea r11, [rbp-2533]
+    mov rbx, 1
+    imul rbx, 8
+    add r11, rbx
+    mov r11, [r11]
+    mov rbx, offset .L.data.56
+    mov rdi, 5
+    mov rsi, r11
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    mov qword ptr [rbp-2517], 3
+    mov qword ptr [rbp-2509], 5
+    lea r11, [rbp-2517]
+    mov rbx, 1
+    imul rbx, 8
+    add r11, rbx
+    mov r11, [r11]
+    mov rbx, offset .L.data.57
+    mov rdi, 5
+    mov rsi, r11
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    mov qword ptr [rbp-2501], 3
+    mov qword ptr [rbp-2493], 5
+    lea r11, [rbp-2493]
+    mov rbx, 1
+    imul rbx, 8
+    sub r11, rbx
+    mov r11, [r11]
+    mov rbx, offset .L.data.58
+    mov rdi, 3
+    mov rsi, r11
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    mov qword ptr [rbp-2485], 3
+    mov qword ptr [rbp-2477], 5
+    lea rbx, [rbp-2485]
+    mov [rbp-2469], rbx
+    mov r11, rbx
+    mov rbx, 1
+    imul rbx, 8
+    add r11, rbx
+    mov r11, [r11]
+    mov rbx, offset .L.data.59
+    mov rdi, 5
+    mov rsi, r11
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    mov qword ptr [rbp-2461], 3
+    mov qword ptr [rbp-2453], 5
+    lea rbx, [rbp-2453]
+    mov [rbp-2445], rbx
+    mov r11, rbx
+    mov rbx, 1
+    imul rbx, 8
+    sub r11, rbx
+    mov r11, [r11]
+    mov rbx, offset .L.data.60
+    mov rdi, 3
+    mov rsi, r11
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    mov qword ptr [rbp-2437], 3
+    lea rbx, [rbp-2437]
+    mov [rbp-2429], rbx
+    mov r11, rbx
+    mov qword ptr [r11], 5
+    mov r11, [rbp-2437]
+    mov rbx, offset .L.data.61
+    mov rdi, 5
+    mov rsi, r11
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    mov qword ptr [rbp-2421], 3
+    mov qword ptr [rbp-2413], 5
+    lea r11, [rbp-2421]
+    mov rbx, 1
+    imul rbx, 8
+    add r11, rbx
+    mov qword ptr [r11], 7
+    mov r11, [rbp-2413]
+    mov rbx, offset .L.data.62
+    mov rdi, 7
+    mov rsi, r11
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    mov qword ptr [rbp-2405], 3
+    mov qword ptr [rbp-2397], 5
+    lea r11, [rbp-2397]
+    mov rbx, 1
+    imul rbx, 8
+    sub r11, rbx
+    mov qword ptr [r11], 7
+    mov r11, [rbp-2405]
+    mov rbx, offset .L.data.63
+    mov rdi, 7
+    mov rsi, r11
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    mov rbx, 8
+    mov qword ptr [rbp-2389], 3
+    mov qword ptr [rbp-2381], 5
+    lea r10, [rbp-2389]
+    mov r11, [rbp-2381]
+    mov rdi, r10
+    mov rsi, r11
+    mov rax, 0
+    call addx
+    mov r10, rax
+    mov r11, offset .L.data.64
+    mov rdi, rbx
+    mov rsi, r10
+    mov rdx, r11
+    mov rax, 0
+    call assert
+    lea rbx, [rbp-2373]
+    mov [rbp-2357], rbx
+    mov r11, rbx
+    mov qword ptr [r11], 3
+    mov r11, [rbp-2373]
+    mov rbx, offset .L.data.65
+    mov rdi, 3
+    mov rsi, r11
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    mov qword ptr [rbp-2349], 3
+    lea r11, [rbp-2349]
+    mov rbx, 1
+    imul rbx, 8
+    add r11, rbx
+    mov qword ptr [r11], 4
+    lea r11, [rbp-2349]
+    mov rbx, 2
+    imul rbx, 8
+    add r11, rbx
+    mov qword ptr [r11], 5
+    mov r11, [rbp-2349]
+    mov rbx, offset .L.data.66
+    mov rdi, 3
+    mov rsi, r11
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    mov r10, 4
+    mov qword ptr [rbp-2325], 3
+    lea r11, [rbp-2325]
+    mov rbx, 1
+    imul rbx, 8
+    add r11, rbx
+    mov qword ptr [r11], 4
+    lea r11, [rbp-2325]
+    mov rbx, 2
+    imul rbx, 8
+    add r11, rbx
+    mov qword ptr [r11], 5
+    lea r11, [rbp-2325]
+    mov rbx, 1
+    imul rbx, 8
+    add r11, rbx
+    mov r11, [r11]
+    mov rbx, offset .L.data.67
+    mov rdi, r10
+    mov rsi, r11
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    mov r10, 5
+    mov qword ptr [rbp-2301], 3
+    lea r11, [rbp-2301]
+    mov rbx, 1
+    imul rbx, 8
+    add r11, rbx
+    mov qword ptr [r11], 4
+    lea r11, [rbp-2301]
+    mov rbx, 2
+    imul rbx, 8
+    add r11, rbx
+    mov qword ptr [r11], 5
+    lea r11, [rbp-2301]
+    mov rbx, 2
+    imul rbx, 8
+    add r11, rbx
+    mov r11, [r11]
+    mov rbx, offset .L.data.68
+    mov rdi, r10
+    mov rsi, r11
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    lea rbx, [rbp-2277]
+    mov [rbp-2229], rbx
+    mov r11, rbx
+    mov qword ptr [r11], 0
+    mov r11, [rbp-2277]
+    mov rbx, offset .L.data.69
+    mov rdi, 0
+    mov rsi, r11
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    lea rbx, [rbp-2221]
+    mov [rbp-2173], rbx
+    mov r11, rbx
+    mov rbx, 1
+    imul rbx, 8
+    add r11, rbx
+    mov qword ptr [r11], 1
+    lea r11, [rbp-2221]
+    mov rbx, 1
+    imul rbx, 8
+    add r11, rbx
+    mov r11, [r11]
+    mov rbx, offset .L.data.70
+    mov rdi, 1
+    mov rsi, r11
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    lea rbx, [rbp-2165]
+    mov [rbp-2117], rbx
+    mov r11, rbx
+    mov rbx, 2
+    imul rbx, 8
+    add r11, rbx
+    mov qword ptr [r11], 2
+    lea r11, [rbp-2165]
+    mov rbx, 2
+    imul rbx, 8
+    add r11, rbx
+    mov r11, [r11]
+    mov rbx, offset .L.data.71
+    mov rdi, 2
+    mov rsi, r11
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    lea rbx, [rbp-2109]
+    mov [rbp-2061], rbx
+    mov r11, rbx
+    mov rbx, 3
+    imul rbx, 8
+    add r11, rbx
+    mov qword ptr [r11], 3
+    lea r11, [rbp-2109]
+    mov rbx, 1
+    imul rbx, 24
+    add r11, rbx
+    mov r11, [r11]
+    mov rbx, offset .L.data.72
+    mov rdi, 3
+    mov rsi, r11
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    mov r10, 4
+    lea rbx, [rbp-2053]
+    mov [rbp-2005], rbx
+    mov r11, rbx
+    mov rbx, 4
+    imul rbx, 8
+    add r11, rbx
+    mov qword ptr [r11], 4
+    lea r11, [rbp-2053]
+    mov rbx, 1
+    imul rbx, 24
+    add r11, rbx
+    mov rbx, 1
+    imul rbx, 8
+    add r11, rbx
+    mov r11, [r11]
+    mov rbx, offset .L.data.73
+    mov rdi, r10
+    mov rsi, r11
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    mov r10, 5
+    lea rbx, [rbp-1997]
+    mov [rbp-1949], rbx
+    mov r11, rbx
+    mov rbx, 5
+    imul rbx, 8
+    add r11, rbx
+    mov qword ptr [r11], 5
+    lea r11, [rbp-1997]
+    mov rbx, 1
+    imul rbx, 24
+    add r11, rbx
+    mov rbx, 2
+    imul rbx, 8
+    add r11, rbx
+    mov r11, [r11]
+    mov rbx, offset .L.data.74
+    mov rdi, r10
+    mov rsi, r11
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    lea rbx, [rbp-1941]
+    mov [rbp-1893], rbx
+    mov r11, rbx
+    mov rbx, 6
+    imul rbx, 8
+    add r11, rbx
+    mov qword ptr [r11], 6
+    lea r11, [rbp-1941]
+    mov rbx, 2
+    imul rbx, 24
+    add r11, rbx
+    mov r11, [r11]
+    mov rbx, offset .L.data.75
+    mov rdi, 6
+    mov rsi, r11
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    mov qword ptr [rbp-1885], 3
+    lea r11, [rbp-1885]
+    mov rbx, 1
+    imul rbx, 8
+    add r11, rbx
+    mov qword ptr [r11], 4
+    lea r11, [rbp-1885]
+    mov rbx, 2
+    imul rbx, 8
+    add r11, rbx
+    mov qword ptr [r11], 5
+    mov r11, [rbp-1885]
+    mov rbx, offset .L.data.76
+    mov rdi, 3
+    mov rsi, r11
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    mov r10, 4
+    mov qword ptr [rbp-1861], 3
+    lea r11, [rbp-1861]
+    mov rbx, 1
+    imul rbx, 8
+    add r11, rbx
+    mov qword ptr [r11], 4
+    lea r11, [rbp-1861]
+    mov rbx, 2
+    imul rbx, 8
+    add r11, rbx
+    mov qword ptr [r11], 5
+    lea r11, [rbp-1861]
+    mov rbx, 1
+    imul rbx, 8
+    add r11, rbx
+    mov r11, [r11]
+    mov rbx, offset .L.data.77
+    mov rdi, r10
+    mov rsi, r11
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    mov r10, 5
+    mov qword ptr [rbp-1837], 3
+    lea r11, [rbp-1837]
+    mov rbx, 1
+    imul rbx, 8
+    add r11, rbx
+    mov qword ptr [r11], 4
+    lea r11, [rbp-1837]
+    mov rbx, 2
+    imul rbx, 8
+    add r11, rbx
+    mov qword ptr [r11], 5
+    lea r11, [rbp-1837]
+    mov rbx, 2
+    imul rbx, 8
+    add r11, rbx
+    mov r11, [r11]
+    mov rbx, offset .L.data.78
+    mov rdi, r10
+    mov rsi, r11
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    mov r10, 5
+    mov qword ptr [rbp-1813], 3
+    lea r11, [rbp-1813]
+    mov rbx, 1
+    imul rbx, 8
+    add r11, rbx
+    mov qword ptr [r11], 4
+    lea r11, [rbp-1813]
+    mov rbx, 2
+    imul rbx, 8
+    add r11, rbx
+    mov qword ptr [r11], 5
+    lea r11, [rbp-1813]
+    mov rbx, 2
+    imul rbx, 8
+    add r11, rbx
+    mov r11, [r11]
+    mov rbx, offset .L.data.79
+    mov rdi, r10
+    mov rsi, r11
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    mov r10, 5
+    mov qword ptr [rbp-1789], 3
+    lea r11, [rbp-1789]
+    mov rbx, 1
+    imul rbx, 8
+    add r11, rbx
+    mov qword ptr [r11], 4
+    lea r11, [rbp-1789]
+    mov rbx, 2
+    imul rbx, 8
+    add r11, rbx
+    mov qword ptr [r11], 5
+    lea r11, [rbp-1789]
+    mov rbx, 2
+    imul rbx, 8
+    add r11, rbx
+    mov r11, [r11]
+    mov rbx, offset .L.data.80
+    mov rdi, r10
+    mov rsi, r11
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    lea rbx, [rbp-1765]
+    mov [rbp-1717], rbx
+    mov r11, rbx
+    mov qword ptr [r11], 0
+    mov r11, [rbp-1765]
+    mov rbx, offset .L.data.81
+    mov rdi, 0
+    mov rsi, r11
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    lea rbx, [rbp-1709]
+    mov [rbp-1661], rbx
+    mov r11, rbx
+    mov rbx, 1
+    imul rbx, 8
+    add r11, rbx
+    mov qword ptr [r11], 1
+    lea r11, [rbp-1709]
+    mov rbx, 1
+    imul rbx, 8
+    add r11, rbx
+    mov r11, [r11]
+    mov rbx, offset .L.data.82
+    mov rdi, 1
+    mov rsi, r11
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    lea rbx, [rbp-1653]
+    mov [rbp-1605], rbx
+    mov r11, rbx
+    mov rbx, 2
+    imul rbx, 8
+    add r11, rbx
+    mov qword ptr [r11], 2
+    lea r11, [rbp-1653]
+    mov rbx, 2
+    imul rbx, 8
+    add r11, rbx
+    mov r11, [r11]
+    mov rbx, offset .L.data.83
+    mov rdi, 2
+    mov rsi, r11
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    lea rbx, [rbp-1597]
+    mov [rbp-1549], rbx
+    mov r11, rbx
+    mov rbx, 3
+    imul rbx, 8
+    add r11, rbx
+    mov qword ptr [r11], 3
+    lea r11, [rbp-1597]
+    mov rbx, 1
+    imul rbx, 24
+    add r11, rbx
+    mov r11, [r11]
+    mov rbx, offset .L.data.84
+    mov rdi, 3
+    mov rsi, r11
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    mov r10, 4
+    lea rbx, [rbp-1541]
+    mov [rbp-1493], rbx
+    mov r11, rbx
+    mov rbx, 4
+    imul rbx, 8
+    add r11, rbx
+    mov qword ptr [r11], 4
+    lea r11, [rbp-1541]
+    mov rbx, 1
+    imul rbx, 24
+    add r11, rbx
+    mov rbx, 1
+    imul rbx, 8
+    add r11, rbx
+    mov r11, [r11]
+    mov rbx, offset .L.data.85
+    mov rdi, r10
+    mov rsi, r11
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    mov r10, 5
+    lea rbx, [rbp-1485]
+    mov [rbp-1437], rbx
+    mov r11, rbx
+    mov rbx, 5
+    imul rbx, 8
+    add r11, rbx
+    mov qword ptr [r11], 5
+    lea r11, [rbp-1485]
+    mov rbx, 1
+    imul rbx, 24
+    add r11, rbx
+    mov rbx, 2
+    imul rbx, 8
+    add r11, rbx
+    mov r11, [r11]
+    mov rbx, offset .L.data.86
+    mov rdi, r10
+    mov rsi, r11
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    lea rbx, [rbp-1429]
+    mov [rbp-1381], rbx
+    mov r11, rbx
+    mov rbx, 6
+    imul rbx, 8
+    add r11, rbx
+    mov qword ptr [r11], 6
+    lea r11, [rbp-1429]
+    mov rbx, 2
+    imul rbx, 24
+    add r11, rbx
+    mov r11, [r11]
+    mov rbx, offset .L.data.87
+    mov rdi, 6
+    mov rsi, r11
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    mov rbx, offset .L.data.88
+    mov rdi, 8
+    mov rsi, 8
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    mov rbx, offset .L.data.89
+    mov rdi, 8
+    mov rsi, 8
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    mov rbx, offset .L.data.90
+    mov rdi, 8
+    mov rsi, 8
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    mov rbx, offset .L.data.91
+    mov rdi, 32
+    mov rsi, 32
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    mov rbx, offset .L.data.92
+    mov rdi, 96
+    mov rsi, 96
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    mov rbx, offset .L.data.93
+    mov rdi, 32
+    mov rsi, 32
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    mov rbx, offset .L.data.94
+    mov rdi, 8
+    mov rsi, 8
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    mov rbx, offset .L.data.95
+    mov rdi, 9
+    mov rsi, 9
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    mov rbx, offset .L.data.96
+    mov rdi, 9
+    mov rsi, 9
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    mov rbx, offset .L.data.97
+    mov rdi, 8
+    mov rsi, 8
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    mov r11, offset g1
+    mov r11, [r11]
+    mov rbx, offset .L.data.98
+    mov rdi, 0
+    mov rsi, r11
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    mov r10, offset g1
+    mov qword ptr [r10], 3
+    mov r11, offset g1
+    mov r11, [r11]
+    mov rbx, offset .L.data.99
+    mov rdi, 3
+    mov rsi, r11
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    mov r10, offset g2
+    mov qword ptr [r10], 0
+    mov r10, offset g2
+    mov r11, 1
+    imul r11, 8
+    add r10, r11
+    mov qword ptr [r10], 1
+    mov r10, offset g2
+    mov r11, 2
+    imul r11, 8
+    add r10, r11
+    mov qword ptr [r10], 2
+    mov r10, offset g2
+    mov r11, 3
+    imul r11, 8
+    add r10, r11
+    mov qword ptr [r10], 3
+    mov r11, offset g2
+    mov r11, [r11]
+    mov rbx, offset .L.data.100
+    mov rdi, 0
+    mov rsi, r11
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    mov r11, offset g2
+    mov rbx, 1
+    imul rbx, 8
+    add r11, rbx
+    mov r11, [r11]
+    mov rbx, offset .L.data.101
+    mov rdi, 1
+    mov rsi, r11
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    mov r11, offset g2
+    mov rbx, 2
+    imul rbx, 8
+    add r11, rbx
+    mov r11, [r11]
+    mov rbx, offset .L.data.102
+    mov rdi, 2
+    mov rsi, r11
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    mov r11, offset g2
+    mov rbx, 3
+    imul rbx, 8
+    add r11, rbx
+    mov r11, [r11]
+    mov rbx, offset .L.data.103
+    mov rdi, 3
+    mov rsi, r11
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    mov rbx, offset .L.data.104
+    mov rdi, 8
+    mov rsi, 8
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    mov rbx, offset .L.data.105
+    mov rdi, 32
+    mov rsi, 32
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    mov rbx, 1
+    mov byte ptr [rbp-741], bl
+    movsx r11, byte ptr [rbp-741]
+    mov rbx, offset .L.data.106
+    mov rdi, 1
+    mov rsi, r11
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    mov rbx, 1
+    mov byte ptr [rbp-740], bl
+    mov rbx, 2
+    mov byte ptr [rbp-739], bl
+    movsx r11, byte ptr [rbp-740]
+    mov rbx, offset .L.data.107
+    mov rdi, 1
+    mov rsi, r11
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    mov rbx, 1
+    mov byte ptr [rbp-738], bl
+    mov rbx, 2
+    mov byte ptr [rbp-737], bl
+    movsx r11, byte ptr [rbp-737]
+    mov rbx, offset .L.data.108
+    mov rdi, 2
+    mov rsi, r11
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    mov rbx, offset .L.data.109
+    mov rdi, 1
+    mov rsi, 1
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    mov rbx, offset .L.data.110
+    mov rdi, 10
+    mov rsi, 10
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    mov rbx, 1
+    mov rdi, 7
+    mov rsi, 3
+    mov rdx, 3
+    mov rax, 0
+    call sub_char
+    mov r10, rax
+    mov r11, offset .L.data.111
+    mov rdi, rbx
+    mov rsi, r10
+    mov rdx, r11
+    mov rax, 0
+    call assert
+    mov r11, offset .L.data.112
+    movsx r11, byte ptr [r11]
+    mov rbx, offset .L.data.113
+    mov rdi, 97
+    mov rsi, r11
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    mov r11, offset .L.data.114
+    mov rbx, 1
+    imul rbx, 1
+    add r11, rbx
+    movsx r11, byte ptr [r11]
+    mov rbx, offset .L.data.115
+    mov rdi, 98
+    mov rsi, r11
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    mov r11, offset .L.data.116
+    mov rbx, 2
+    imul rbx, 1
+    add r11, rbx
+    movsx r11, byte ptr [r11]
+    mov rbx, offset .L.data.117
+    mov rdi, 99
+    mov rsi, r11
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    mov r11, offset .L.data.118
+    mov rbx, 3
+    imul rbx, 1
+    add r11, rbx
+    movsx r11, byte ptr [r11]
+    mov rbx, offset .L.data.119
+    mov rdi, 0
+    mov rsi, r11
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    mov rbx, offset .L.data.121
+    mov rdi, 4
+    mov rsi, 4
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    mov r11, offset .L.data.122
+    movsx r11, byte ptr [r11]
+    mov rbx, offset .L.data.123
+    mov rdi, 7
+    mov rsi, r11
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    mov r11, offset .L.data.124
+    movsx r11, byte ptr [r11]
+    mov rbx, offset .L.data.125
+    mov rdi, 8
+    mov rsi, r11
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    mov r11, offset .L.data.126
+    movsx r11, byte ptr [r11]
+    mov rbx, offset .L.data.127
+    mov rdi, 9
+    mov rsi, r11
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    mov r11, offset .L.data.128
+    movsx r11, byte ptr [r11]
+    mov rbx, offset .L.data.129
+    mov rdi, 10
+    mov rsi, r11
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    mov r11, offset .L.data.130
+    movsx r11, byte ptr [r11]
+    mov rbx, offset .L.data.131
+    mov rdi, 11
+    mov rsi, r11
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    mov r11, offset .L.data.132
+    movsx r11, byte ptr [r11]
+    mov rbx, offset .L.data.133
+    mov rdi, 12
+    mov rsi, r11
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    mov r11, offset .L.data.134
+    movsx r11, byte ptr [r11]
+    mov rbx, offset .L.data.135
+    mov rdi, 13
+    mov rsi, r11
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    mov r11, offset .L.data.136
+    movsx r11, byte ptr [r11]
+    mov rbx, offset .L.data.137
+    mov rdi, 27
+    mov rsi, r11
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    mov r11, offset .L.data.138
+    movsx r11, byte ptr [r11]
+    mov rbx, offset .L.data.139
+    mov rdi, 0
+    mov rsi, r11
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    mov r11, offset .L.data.140
+    movsx r11, byte ptr [r11]
+    mov rbx, offset .L.data.141
+    mov rdi, 106
+    mov rsi, r11
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    mov r11, offset .L.data.142
+    movsx r11, byte ptr [r11]
+    mov rbx, offset .L.data.143
+    mov rdi, 107
+    mov rsi, r11
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    mov r11, offset .L.data.144
+    movsx r11, byte ptr [r11]
+    mov rbx, offset .L.data.145
+    mov rdi, 108
+    mov rsi, r11
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    mov qword ptr [rbp-725], 2
+    mov qword ptr [rbp-717], 3
+    mov r11, [rbp-725]
+    mov rbx, offset .L.data.146
+    mov rdi, 2
+    mov rsi, r11
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    mov qword ptr [rbp-709], 2
+    mov qword ptr [rbp-701], 3
+    mov qword ptr [rbp-693], 4
+    mov r11, [rbp-709]
+    mov rbx, offset .L.data.147
+    mov rdi, 2
+    mov rsi, r11
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    mov qword ptr [rbp-685], 2
+    mov qword ptr [rbp-685], 3
+    mov r11, [rbp-685]
+    mov rbx, offset .L.data.148
+    mov rdi, 3
+    mov rsi, r11
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    mov qword ptr [rbp-677], 2
+    mov qword ptr [rbp-669], 3
+    mov r11, [rbp-677]
+    mov rbx, [rbp-669]
+    add r11, rbx
+    mov rbx, offset .L.data.149
+    mov rdi, 5
+    mov rsi, r11
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    lea r11, [rbp-661]
+    add r11, 0
+    mov qword ptr [r11], 1
+    lea r11, [rbp-661]
+    add r11, 8
+    mov qword ptr [r11], 2
+    lea r11, [rbp-661]
+    add r11, 0
+    mov r11, [r11]
+    mov rbx, offset .L.data.150
+    mov rdi, 1
+    mov rsi, r11
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    lea r11, [rbp-645]
+    add r11, 0
+    mov qword ptr [r11], 1
+    lea r11, [rbp-645]
+    add r11, 8
+    mov qword ptr [r11], 2
+    lea r11, [rbp-645]
+    add r11, 8
+    mov r11, [r11]
+    mov rbx, offset .L.data.151
+    mov rdi, 2
+    mov rsi, r11
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    lea r11, [rbp-629]
+    add r11, 0
+    mov rbx, 1
+    mov byte ptr [r11], bl
+    lea r11, [rbp-629]
+    add r11, 1
+    mov qword ptr [r11], 2
+    lea r11, [rbp-629]
+    add r11, 9
+    mov rbx, 3
+    mov byte ptr [r11], bl
+    lea r11, [rbp-629]
+    add r11, 0
+    movsx r11, byte ptr [r11]
+    mov rbx, offset .L.data.152
+    mov rdi, 1
+    mov rsi, r11
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    lea r11, [rbp-619]
+    add r11, 1
+    mov qword ptr [r11], 1
+    lea r11, [rbp-619]
+    add r11, 1
+    mov qword ptr [r11], 2
+    lea r11, [rbp-619]
+    add r11, 9
+    mov rbx, 3
+    mov byte ptr [r11], bl
+    lea r11, [rbp-619]
+    add r11, 1
+    mov r11, [r11]
+    mov rbx, offset .L.data.153
+    mov rdi, 2
+    mov rsi, r11
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    lea r11, [rbp-609]
+    add r11, 0
+    mov rbx, 1
+    mov byte ptr [r11], bl
+    lea r11, [rbp-609]
+    add r11, 1
+    mov qword ptr [r11], 2
+    lea r11, [rbp-609]
+    add r11, 9
+    mov rbx, 3
+    mov byte ptr [r11], bl
+    lea r11, [rbp-609]
+    add r11, 9
+    movsx r11, byte ptr [r11]
+    mov rbx, offset .L.data.154
+    mov rdi, 3
+    mov rsi, r11
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    lea rbx, [rbp-599]
+    mov [rbp-551], rbx
+    mov r11, rbx
+    mov qword ptr [r11], 0
+    lea r11, [rbp-599]
+    add r11, 0
+    mov r11, [r11]
+    mov rbx, offset .L.data.155
+    mov rdi, 0
+    mov rsi, r11
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    lea rbx, [rbp-543]
+    mov [rbp-495], rbx
+    mov r11, rbx
+    mov rbx, 1
+    imul rbx, 8
+    add r11, rbx
+    mov qword ptr [r11], 1
+    lea r11, [rbp-543]
+    add r11, 8
+    mov r11, [r11]
+    mov rbx, offset .L.data.156
+    mov rdi, 1
+    mov rsi, r11
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    lea rbx, [rbp-487]
+    mov [rbp-439], rbx
+    mov r11, rbx
+    mov rbx, 2
+    imul rbx, 8
+    add r11, rbx
+    mov qword ptr [r11], 2
+    lea r11, [rbp-487]
+    mov rbx, 1
+    imul rbx, 16
+    add r11, rbx
+    add r11, 0
+    mov r11, [r11]
+    mov rbx, offset .L.data.157
+    mov rdi, 2
+    mov rsi, r11
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    lea rbx, [rbp-431]
+    mov [rbp-383], rbx
+    mov r11, rbx
+    mov rbx, 3
+    imul rbx, 8
+    add r11, rbx
+    mov qword ptr [r11], 3
+    lea r11, [rbp-431]
+    mov rbx, 1
+    imul rbx, 16
+    add r11, rbx
+    add r11, 8
+    mov r11, [r11]
+    mov rbx, offset .L.data.158
+    mov rdi, 3
+    mov rsi, r11
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    lea rbx, [rbp-375]
+    mov [rbp-311], rbx
+    lea r11, [rbp-375]
+    add r11, 0
+    mov qword ptr [r11], 6
+    mov r11, [rbp-311]
+    mov r11, [r11]
+    mov rbx, offset .L.data.159
+    mov rdi, 6
+    mov rsi, r11
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    lea rbx, [rbp-303]
+    mov [rbp-239], rbx
+    lea r11, [rbp-303]
+    add r11, 24
+    mov qword ptr [r11], 7
+    mov r11, [rbp-239]
+    mov rbx, 3
+    imul rbx, 8
+    add r11, rbx
+    mov r11, [r11]
+    mov rbx, offset .L.data.160
+    mov rdi, 7
+    mov rsi, r11
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    lea r11, [rbp-231]
+    add r11, 0
+    add r11, 0
+    mov qword ptr [r11], 6
+    lea r11, [rbp-231]
+    add r11, 0
+    add r11, 0
+    mov r11, [r11]
+    mov rbx, offset .L.data.161
+    mov rdi, 6
+    mov rsi, r11
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    lea r11, [rbp-223]
+    add r11, 0
+    mov qword ptr [r11], 1
+    lea r11, [rbp-207]
+    lea rbx, [rbp-223]
+    mov r12, [rbx]
+    mov [r11], r12
+    add rbx, 8
+    add r11, 8
+    mov rbx, [rbx]
+    mov [r11], rbx
+    lea r11, [rbp-207]
+    add r11, 0
+    mov r11, [r11]
+    mov rbx, offset .L.data.162
+    mov rdi, 1
+    mov rsi, r11
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    lea r11, [rbp-191]
+    add r11, 8
+    mov qword ptr [r11], 2
+    lea r11, [rbp-175]
+    lea rbx, [rbp-191]
+    mov r12, [rbx]
+    mov [r11], r12
+    add rbx, 8
+    add r11, 8
+    mov rbx, [rbx]
+    mov [r11], rbx
+    lea r11, [rbp-175]
+    add r11, 8
+    mov r11, [r11]
+    mov rbx, offset .L.data.163
+    mov rdi, 2
+    mov rsi, r11
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    mov r10, 3
+    lea r11, [rbp-159]
+    add r11, 9
+    mov rbx, 3
+    mov byte ptr [r11], bl
+    lea r11, [rbp-149]
+    lea rbx, [rbp-159]
+    mov r12, [rbx]
+    mov [r11], r12
+    mov r12, 8
+    add r12, rbx
+    mov r13, 8
+    add r13, r11
+    movsx r12, byte ptr [r12]
+    mov byte ptr [r13], r12b
+    add rbx, 9
+    add r11, 9
+    movsx rbx, byte ptr [rbx]
+    mov byte ptr [r11], bl
+    lea r11, [rbp-149]
+    add r11, 9
+    movsx r11, byte ptr [r11]
+    mov rbx, offset .L.data.164
+    mov rdi, r10
+    mov rsi, r11
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    mov rbx, offset .L.data.165
+    mov rdi, 8
+    mov rsi, 8
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    mov rbx, offset .L.data.166
+    mov rdi, 16
+    mov rsi, 16
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    mov rbx, offset .L.data.167
+    mov rdi, 24
+    mov rsi, 24
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    mov rbx, offset .L.data.168
+    mov rdi, 32
+    mov rsi, 32
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    mov rbx, offset .L.data.169
+    mov rdi, 48
+    mov rsi, 48
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    mov rbx, offset .L.data.170
+    mov rdi, 2
+    mov rsi, 2
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    mov rbx, offset .L.data.171
+    mov rdi, 9
+    mov rsi, 9
+    mov rdx, rbx
+    mov rax, 0
+    call assert
+    mov r10, offset .L.data.172
+    mov rdi, r10
+    mov rax, 0
+    call printf
+    mov rax, 0
+.Lreturn.main:
+    mov rbx, [rbp-2765]
+    mov r12, [rbp-2773]
+    mov r13, [rbp-2781]
+    mov r14, [rbp-2789]
+    mov r15, [rbp-2797]
+    mov rsp, rbp
+    pop rbp
+    ret
+.data
+.L.data.172:
+    .byte 79,75,10,0
+.L.data.171:
+    .byte 115,116,114,117,99,116,32,123,99,104,97,114,32,97,59,32,105,110,116,32,98,59,125,32,120,59,32,115,105,122,101,111,102,40,120,41,59,0
+.L.data.170:
+    .byte 115,116,114,117,99,116,32,123,99,104,97,114,32,97,59,32,99,104,97,114,32,98,59,125,32,120,59,32,115,105,122,101,111,102,40,120,41,59,0
+.L.data.169:
+    .byte 115,116,114,117,99,116,32,123,105,110,116,32,97,91,51,93,59,125,32,120,91,50,93,59,32,115,105,122,101,111,102,40,120,41,125,59,0
+.L.data.168:
+    .byte 115,116,114,117,99,116,32,123,105,110,116,32,97,59,125,32,120,91,52,93,59,32,115,105,122,101,111,102,40,120,41,59,0
+.L.data.167:
+    .byte 115,116,114,117,99,116,32,123,105,110,116,32,97,91,51,93,59,125,32,120,59,32,115,105,122,101,111,102,40,120,41,59,0
+.L.data.166:
+    .byte 115,116,114,117,99,116,32,123,105,110,116,32,97,59,32,105,110,116,32,98,59,125,32,120,59,32,115,105,122,101,111,102,40,120,41,59,0
+.L.data.165:
+    .byte 115,116,114,117,99,116,32,123,105,110,116,32,97,59,125,32,120,59,32,115,105,122,101,111,102,40,120,41,59,0
+.L.data.164:
+    .byte 115,116,114,117,99,116,32,123,99,104,97,114,32,97,59,32,105,110,116,32,98,59,32,99,104,97,114,32,99,59,125,32,120,59,32,115,116,114,117,99,116,32,123,99,104,97,114,32,97,59,32,105,110,116,32,98,59,32,99,104,97,114,32,99,59,125,32,121,59,32,120,46,99,61,51,59,32,121,61,120,59,32,121,46,99,59,0
+.L.data.163:
+    .byte 115,116,114,117,99,116,32,123,105,110,116,32,97,59,32,105,110,116,32,98,59,125,32,120,59,32,115,116,114,117,99,116,32,123,105,110,116,32,97,59,32,105,110,116,32,98,59,125,32,121,59,32,120,46,98,61,50,59,32,121,61,120,59,32,121,46,98,59,0
+.L.data.162:
+    .byte 115,116,114,117,99,116,32,123,105,110,116,32,97,59,32,105,110,116,32,98,59,125,32,120,59,32,115,116,114,117,99,116,32,123,105,110,116,32,97,59,32,105,110,116,32,98,59,125,32,121,59,32,120,46,97,61,49,59,32,121,61,120,59,32,121,46,97,59,0
+.L.data.161:
+    .byte 115,116,114,117,99,116,32,123,32,115,116,114,117,99,116,32,123,32,105,110,116,32,98,59,32,125,32,97,59,32,125,32,120,59,32,120,46,97,46,98,61,54,59,32,120,46,97,46,98,59,0
+.L.data.160:
+    .byte 115,116,114,117,99,116,32,123,105,110,116,32,97,91,51,93,59,32,105,110,116,32,98,91,53,93,59,125,32,120,59,32,105,110,116,32,42,112,61,38,120,59,32,120,46,98,91,48,93,61,55,59,32,112,91,51,93,59,0
+.L.data.159:
+    .byte 115,116,114,117,99,116,32,123,105,110,116,32,97,91,51,93,59,32,105,110,116,32,98,91,53,93,59,125,32,120,59,32,105,110,116,32,42,112,61,38,120,59,32,120,46,97,91,48,93,61,54,59,32,112,91,48,93,59,0
+.L.data.158:
+    .byte 115,116,114,117,99,116,32,123,105,110,116,32,97,59,32,105,110,116,32,98,59,125,32,120,91,51,93,59,32,105,110,116,32,42,112,61,120,59,32,112,91,51,93,61,51,59,32,120,91,49,93,46,98,59,0
+.L.data.157:
+    .byte 115,116,114,117,99,116,32,123,105,110,116,32,97,59,32,105,110,116,32,98,59,125,32,120,91,51,93,59,32,105,110,116,32,42,112,61,120,59,32,112,91,50,93,61,50,59,32,120,91,49,93,46,97,59,0
+.L.data.156:
+    .byte 115,116,114,117,99,116,32,123,105,110,116,32,97,59,32,105,110,116,32,98,59,125,32,120,91,51,93,59,32,105,110,116,32,42,112,61,120,59,32,112,91,49,93,61,49,59,32,120,91,48,93,46,98,59,0
+.L.data.155:
+    .byte 115,116,114,117,99,116,32,123,105,110,116,32,97,59,32,105,110,116,32,98,59,125,32,120,91,51,93,59,32,105,110,116,32,42,112,61,120,59,32,112,91,48,93,61,48,59,32,120,91,48,93,46,97,59,0
+.L.data.154:
+    .byte 115,116,114,117,99,116,32,123,99,104,97,114,32,97,59,32,105,110,116,32,98,59,32,99,104,97,114,32,99,59,125,32,120,59,32,120,46,97,61,49,59,32,120,46,98,61,50,59,32,120,46,99,61,51,59,32,120,46,99,59,0
+.L.data.153:
+    .byte 115,116,114,117,99,116,32,123,99,104,97,114,32,97,59,32,105,110,116,32,98,59,32,99,104,97,114,32,99,59,125,32,97,59,32,120,46,98,61,120,59,32,120,46,97,61,50,59,32,120,46,98,61,51,59,32,120,46,98,59,0
+.L.data.152:
+    .byte 115,116,114,117,99,116,32,123,99,104,97,114,32,97,59,32,105,110,116,32,98,59,32,99,104,97,114,32,99,59,125,32,120,59,32,120,46,97,61,49,59,32,120,46,98,61,50,59,32,120,46,99,61,51,59,32,120,46,97,59,0
+.L.data.151:
+    .byte 115,116,114,117,99,116,32,123,105,110,116,32,97,59,32,105,110,116,32,98,59,125,32,120,59,32,120,46,97,61,49,59,32,120,46,98,61,50,59,32,120,46,98,59,0
+.L.data.150:
+    .byte 115,116,114,117,99,116,32,123,105,110,116,32,97,59,32,105,110,116,32,98,59,125,32,120,59,32,120,46,97,61,49,59,32,120,46,98,61,50,59,32,120,46,97,59,0
+.L.data.149:
+    .byte 105,110,116,32,105,110,116,95,120,61,50,59,32,105,110,116,32,105,102,102,61,51,59,32,105,110,116,95,120,43,105,102,102,59,0
+.L.data.148:
+    .byte 105,110,116,32,120,61,50,59,32,123,32,120,61,51,59,32,125,32,120,59,0
+.L.data.147:
+    .byte 105,110,116,32,120,61,50,59,32,123,32,105,110,116,32,120,61,51,59,32,125,32,105,110,116,32,121,61,52,59,32,120,59,0
+.L.data.146:
+    .byte 105,110,116,32,120,61,50,59,32,123,32,105,110,116,32,120,61,51,59,32,125,32,120,59,0
+.L.data.145:
+    .byte 34,92,108,34,91,48,93,0
+.L.data.144:
+    .byte 108,0
+.L.data.143:
+    .byte 34,92,107,34,91,48,93,0
+.L.data.142:
+    .byte 107,0
+.L.data.141:
+    .byte 34,92,106,34,91,48,93,0
+.L.data.140:
+    .byte 106,0
+.L.data.139:
+    .byte 34,92,48,34,91,48,93,0
+.L.data.138:
+    .byte 0,0
+.L.data.137:
+    .byte 34,92,101,34,91,48,93,0
+.L.data.136:
+    .byte 27,0
+.L.data.135:
+    .byte 34,92,114,34,91,48,93,0
+.L.data.134:
+    .byte 13,0
+.L.data.133:
+    .byte 34,92,102,34,91,48,93,0
+.L.data.132:
+    .byte 12,0
+.L.data.131:
+    .byte 34,92,118,34,91,48,93,0
+.L.data.130:
+    .byte 11,0
+.L.data.129:
+    .byte 34,92,110,34,91,48,93,0
+.L.data.128:
+    .byte 10,0
+.L.data.127:
+    .byte 34,92,116,34,91,48,93,0
+.L.data.126:
+    .byte 9,0
+.L.data.125:
+    .byte 34,92,98,34,91,48,93,0
+.L.data.124:
+    .byte 8,0
+.L.data.123:
+    .byte 34,92,97,34,91,48,93,0
+.L.data.122:
+    .byte 7,0
+.L.data.121:
+    .byte 115,105,122,101,111,102,40,34,97,98,99,34,41,0
+.L.data.120:
+    .byte 97,98,99,0
+.L.data.119:
+    .byte 34,97,98,99,34,91,51,93,0
+.L.data.118:
+    .byte 97,98,99,0
+.L.data.117:
+    .byte 34,97,98,99,34,91,50,93,0
+.L.data.116:
+    .byte 97,98,99,0
+.L.data.115:
+    .byte 34,97,98,99,34,91,49,93,0
+.L.data.114:
+    .byte 97,98,99,0
+.L.data.113:
+    .byte 34,97,98,99,34,91,48,93,0
+.L.data.112:
+    .byte 97,98,99,0
+.L.data.111:
+    .byte 115,117,98,95,99,104,97,114,40,55,44,32,51,44,32,51,41,0
+.L.data.110:
+    .byte 99,104,97,114,32,120,91,49,48,93,59,32,115,105,122,101,111,102,40,120,41,59,0
+.L.data.109:
+    .byte 99,104,97,114,32,120,59,32,115,105,122,101,111,102,40,120,41,59,0
+.L.data.108:
+    .byte 99,104,97,114,32,120,61,49,59,32,99,104,97,114,32,121,61,50,59,32,121,59,0
+.L.data.107:
+    .byte 99,104,97,114,32,120,61,49,59,32,99,104,97,114,32,121,61,50,59,32,120,59,0
+.L.data.106:
+    .byte 99,104,97,114,32,120,61,49,59,32,120,59,0
+.L.data.105:
+    .byte 115,105,122,101,111,102,40,103,50,41,0
+.L.data.104:
+    .byte 115,105,122,101,111,102,40,103,49,41,0
+.L.data.103:
+    .byte 103,50,91,51,93,0
+.L.data.102:
+    .byte 103,50,91,50,93,0
+.L.data.101:
+    .byte 103,50,91,49,93,0
+.L.data.100:
+    .byte 103,50,91,48,93,0
+.L.data.99:
+    .byte 103,49,0
+.L.data.98:
+    .byte 103,49,0
+.L.data.97:
+    .byte 105,110,116,32,120,91,51,93,91,52,93,59,32,115,105,122,101,111,102,40,42,42,120,32,43,32,49,41,59,0
+.L.data.96:
+    .byte 105,110,116,32,120,91,51,93,91,52,93,59,32,115,105,122,101,111,102,32,42,42,120,32,43,32,49,59,0
+.L.data.95:
+    .byte 105,110,116,32,120,91,51,93,91,52,93,59,32,115,105,122,101,111,102,40,42,42,120,41,32,43,32,49,59,0
+.L.data.94:
+    .byte 105,110,116,32,120,91,51,93,91,52,93,59,32,115,105,122,101,111,102,40,42,42,120,41,59,0
+.L.data.93:
+    .byte 105,110,116,32,120,91,51,93,91,52,93,59,32,115,105,122,101,111,102,40,42,120,41,59,0
+.L.data.92:
+    .byte 105,110,116,32,120,91,51,93,91,52,93,59,32,115,105,122,101,111,102,40,120,41,59,0
+.L.data.91:
+    .byte 105,110,116,32,120,91,52,93,59,32,115,105,122,101,111,102,40,120,41,59,0
+.L.data.90:
+    .byte 105,110,116,32,42,120,59,32,115,105,122,101,111,102,40,120,41,59,0
+.L.data.89:
+    .byte 105,110,116,32,120,59,32,115,105,122,101,111,102,32,120,59,0
+.L.data.88:
+    .byte 105,110,116,32,120,59,32,115,105,122,101,111,102,40,120,41,59,0
+.L.data.87:
+    .byte 105,110,116,32,120,91,50,93,91,51,93,59,32,105,110,116,32,42,121,61,120,59,32,121,91,54,93,61,54,59,32,120,91,50,93,91,48,93,59,0
+.L.data.86:
+    .byte 105,110,116,32,120,91,50,93,91,51,93,59,32,105,110,116,32,42,121,61,120,59,32,121,91,53,93,61,53,59,32,120,91,49,93,91,50,93,59,0
+.L.data.85:
+    .byte 105,110,116,32,120,91,50,93,91,51,93,59,32,105,110,116,32,42,121,61,120,59,32,121,91,52,93,61,52,59,32,120,91,49,93,91,49,93,59,0
+.L.data.84:
+    .byte 105,110,116,32,120,91,50,93,91,51,93,59,32,105,110,116,32,42,121,61,120,59,32,121,91,51,93,61,51,59,32,120,91,49,93,91,48,93,59,0
+.L.data.83:
+    .byte 105,110,116,32,120,91,50,93,91,51,93,59,32,105,110,116,32,42,121,61,120,59,32,121,91,50,93,61,50,59,32,120,91,48,93,91,50,93,59,0
+.L.data.82:
+    .byte 105,110,116,32,120,91,50,93,91,51,93,59,32,105,110,116,32,42,121,61,120,59,32,121,91,49,93,61,49,59,32,120,91,48,93,91,49,93,59,0
+.L.data.81:
+    .byte 105,110,116,32,120,91,50,93,91,51,93,59,32,105,110,116,32,42,121,61,120,59,32,121,91,48,93,61,48,59,32,120,91,48,93,91,48,93,59,0
+.L.data.80:
+    .byte 105,110,116,32,120,91,51,93,59,32,42,120,61,51,59,32,120,91,49,93,61,52,59,32,50,91,120,93,61,53,59,32,42,40,120,43,50,41,59,0
+.L.data.79:
+    .byte 105,110,116,32,120,91,51,93,59,32,42,120,61,51,59,32,120,91,49,93,61,52,59,32,120,91,50,93,61,53,59,32,42,40,120,43,50,41,59,0
+.L.data.78:
+    .byte 105,110,116,32,120,91,51,93,59,32,42,120,61,51,59,32,120,91,49,93,61,52,59,32,120,91,50,93,61,53,59,32,42,40,120,43,50,41,59,0
+.L.data.77:
+    .byte 105,110,116,32,120,91,51,93,59,32,42,120,61,51,59,32,120,91,49,93,61,52,59,32,120,91,50,93,61,53,59,32,42,40,120,43,49,41,59,0
+.L.data.76:
+    .byte 105,110,116,32,120,91,51,93,59,32,42,120,61,51,59,32,120,91,49,93,61,52,59,32,120,91,50,93,61,53,59,32,42,120,59,0
+.L.data.75:
+    .byte 105,110,116,32,120,91,50,93,91,51,93,59,32,105,110,116,32,42,121,61,120,59,32,42,40,121,43,54,41,61,54,59,32,42,42,40,120,43,50,41,59,0
+.L.data.74:
+    .byte 105,110,116,32,120,91,50,93,91,51,93,59,32,105,110,116,32,42,121,61,120,59,32,42,40,121,43,53,41,61,53,59,32,42,40,42,40,120,43,49,41,43,50,41,59,0
+.L.data.73:
+    .byte 105,110,116,32,120,91,50,93,91,51,93,59,32,105,110,116,32,42,121,61,120,59,32,42,40,121,43,52,41,61,52,59,32,42,40,42,40,120,43,49,41,43,49,41,59,0
+.L.data.72:
+    .byte 105,110,116,32,120,91,50,93,91,51,93,59,32,105,110,116,32,42,121,61,120,59,32,42,40,121,43,51,41,61,51,59,32,42,42,40,120,43,49,41,59,0
+.L.data.71:
+    .byte 105,110,116,32,120,91,50,93,91,51,93,59,32,105,110,116,32,42,121,61,120,59,32,42,40,121,43,50,41,61,50,59,32,42,40,42,120,43,50,41,59,0
+.L.data.70:
+    .byte 105,110,116,32,120,91,50,93,91,51,93,59,32,105,110,116,32,42,121,61,120,59,32,42,40,121,43,49,41,61,49,59,32,42,40,42,120,43,49,41,59,0
+.L.data.69:
+    .byte 105,110,116,32,120,91,50,93,91,51,93,59,32,105,110,116,32,42,121,61,120,59,32,42,121,61,48,59,32,42,42,120,59,0
+.L.data.68:
+    .byte 105,110,116,32,120,91,51,93,59,32,42,120,61,51,59,32,42,40,120,43,49,41,61,52,59,32,42,40,120,43,50,41,61,53,59,32,42,40,120,43,50,41,59,0
+.L.data.67:
+    .byte 105,110,116,32,120,91,51,93,59,32,42,120,61,51,59,32,42,40,120,43,49,41,61,52,59,32,42,40,120,43,50,41,61,53,59,32,42,40,120,43,49,41,59,0
+.L.data.66:
+    .byte 105,110,116,32,120,91,51,93,59,32,42,120,61,51,59,32,42,40,120,43,49,41,61,52,59,32,42,40,120,43,50,41,61,53,59,32,42,120,59,0
+.L.data.65:
+    .byte 105,110,116,32,120,91,50,93,59,32,105,110,116,32,42,121,61,38,120,59,32,42,121,61,51,59,32,42,120,59,0
+.L.data.64:
+    .byte 105,110,116,32,120,61,51,59,32,105,110,116,32,121,61,53,59,32,97,100,100,120,40,38,120,44,32,121,41,59,0
+.L.data.63:
+    .byte 105,110,116,32,120,61,51,59,32,105,110,116,32,121,61,53,59,32,42,40,38,121,45,49,41,61,55,59,32,120,59,0
+.L.data.62:
+    .byte 105,110,116,32,120,61,51,59,32,105,110,116,32,121,61,53,59,32,42,40,38,120,43,49,41,61,55,59,32,121,59,0
+.L.data.61:
+    .byte 105,110,116,32,120,61,51,59,32,105,110,116,32,42,121,61,38,120,59,32,42,121,61,53,59,32,120,59,0
+.L.data.60:
+    .byte 105,110,116,32,120,61,51,59,32,105,110,116,32,121,61,53,59,32,105,110,116,32,42,122,61,38,121,59,32,42,40,122,45,49,41,59,0
+.L.data.59:
+    .byte 105,110,116,32,120,61,51,59,32,105,110,116,32,121,61,53,59,32,105,110,116,32,42,122,61,38,120,59,32,42,40,122,43,49,41,59,0
+.L.data.58:
+    .byte 105,110,116,32,120,61,51,59,32,105,110,116,32,121,61,53,59,32,42,40,38,121,45,49,41,59,0
+.L.data.57:
+    .byte 105,110,116,32,120,61,51,59,32,105,110,116,32,121,61,53,59,32,42,40,49,43,38,120,41,59,0
+.L.data.56:
+    .byte 105,110,116,32,120,61,51,59,32,105,110,116,32,121,61,53,59,32,42,40,38,120,43,49,41,59,0
+.L.data.55:
+    .byte 105,110,116,32,120,61,51,59,32,105,110,116,32,42,121,61,38,120,59,32,105,110,116,32,42,42,122,61,38,121,59,32,42,42,122,59,0
+.L.data.54:
+    .byte 105,110,116,32,120,61,51,59,32,42,38,120,59,0
+.L.data.53:
+    .byte 102,105,98,40,57,41,0
+.L.data.52:
+    .byte 97,100,100,54,40,49,44,50,44,51,44,52,44,53,44,54,41,0
+.L.data.51:
+    .byte 115,117,98,40,53,44,32,51,41,0
+.L.data.50:
+    .byte 97,100,100,40,51,44,32,53,41,0
+.L.data.49:
+    .byte 105,110,116,32,120,61,51,59,32,120,42,49,43,48,43,40,120,45,48,41,42,48,43,52,47,49,59,0
+.L.data.48:
+    .byte 105,110,116,32,105,61,48,59,32,119,104,105,108,101,32,40,48,41,32,105,61,57,59,32,102,111,114,32,40,105,61,53,59,32,48,59,32,105,61,105,43,49,41,32,105,61,57,59,32,105,59,0
+.L.data.47:
+    .byte 105,110,116,32,120,61,48,59,32,105,102,32,40,48,41,32,120,61,49,59,32,101,108,115,101,32,120,61,50,59,32,120,59,0
+.L.data.46:
+    .byte 105,110,116,32,105,61,48,59,32,105,110,116,32,106,61,48,59,32,102,111,114,32,40,105,61,48,59,32,105,60,61,49,48,59,32,105,61,105,43,49,41,32,106,61,105,43,106,59,32,106,59,0
+.L.data.45:
+    .byte 105,110,116,32,105,61,48,59,32,105,110,116,32,106,61,48,59,32,119,104,105,108,101,40,105,60,61,49,48,41,32,123,106,61,105,43,106,59,32,105,61,105,43,49,59,125,32,106,59,0
+.L.data.44:
+    .byte 105,110,116,32,105,61,48,59,32,105,61,48,59,32,119,104,105,108,101,40,105,60,49,48,41,32,105,61,105,43,49,59,32,105,59,0
+.L.data.43:
+    .byte 49,59,32,123,50,59,125,32,51,59,0
+.L.data.42:
+    .byte 105,110,116,32,120,61,48,59,32,105,102,32,40,50,45,49,41,32,120,61,50,59,32,101,108,115,101,32,120,61,51,59,32,120,59,0
+.L.data.41:
+    .byte 105,110,116,32,120,61,48,59,32,105,102,32,40,49,41,32,120,61,50,59,32,101,108,115,101,32,120,61,51,59,32,120,59,0
+.L.data.40:
+    .byte 105,110,116,32,120,61,48,59,32,105,102,32,40,49,45,49,41,32,120,61,50,59,32,101,108,115,101,32,120,61,51,59,32,120,59,0
+.L.data.39:
+    .byte 105,110,116,32,120,61,48,59,32,105,102,32,40,48,41,32,120,61,50,59,32,101,108,115,101,32,120,61,51,59,32,120,59,0
+.L.data.38:
+    .byte 114,101,116,51,40,41,59,0
+.L.data.37:
+    .byte 105,110,116,32,102,111,111,49,50,51,61,51,59,32,105,110,116,32,98,97,114,61,53,59,32,102,111,111,49,50,51,43,98,97,114,59,0
+.L.data.36:
+    .byte 105,110,116,32,102,111,111,61,51,59,32,102,111,111,59,0
+.L.data.35:
+    .byte 105,110,116,32,97,61,51,59,32,105,110,116,32,122,61,53,59,32,97,43,122,59,0
+.L.data.34:
+    .byte 105,110,116,32,97,61,51,59,32,97,59,0
+.L.data.33:
+    .byte 105,110,116,32,97,59,32,105,110,116,32,122,59,32,97,61,51,59,32,122,61,53,59,32,97,43,122,59,0
+.L.data.32:
+    .byte 105,110,116,32,97,59,32,97,61,51,59,32,97,59,0
+.L.data.31:
+    .byte 49,62,61,50,0
+.L.data.30:
+    .byte 49,62,61,49,0
+.L.data.29:
+    .byte 49,62,61,48,0
+.L.data.28:
+    .byte 49,62,50,0
+.L.data.27:
+    .byte 49,62,49,0
+.L.data.26:
+    .byte 49,62,48,0
+.L.data.25:
+    .byte 50,60,61,49,0
+.L.data.24:
+    .byte 49,60,61,49,0
+.L.data.23:
+    .byte 48,60,61,49,0
+.L.data.22:
+    .byte 50,60,49,0
+.L.data.21:
+    .byte 49,60,49,0
+.L.data.20:
+    .byte 48,60,49,0
+.L.data.19:
+    .byte 52,50,33,61,52,50,0
+.L.data.18:
+    .byte 48,33,61,49,0
+.L.data.17:
+    .byte 52,50,61,61,52,50,0
+.L.data.16:
+    .byte 48,61,61,49,0
+.L.data.15:
+    .byte 45,40,49,45,50,41,42,45,40,45,51,41,0
+.L.data.14:
+    .byte 49,43,40,40,40,40,50,42,51,41,41,41,41,0
+.L.data.13:
+    .byte 45,32,45,32,43,49,48,0
+.L.data.12:
+    .byte 45,32,45,49,48,0
+.L.data.11:
+    .byte 48,0
+.L.data.10:
+    .byte 40,51,43,53,41,47,50,0
+.L.data.9:
+    .byte 53,42,40,57,45,54,41,0
+.L.data.8:
+    .byte 48,0
+.L.data.7:
+    .byte 32,49,50,32,43,32,51,52,32,45,32,53,32,0
+.L.data.6:
+    .byte 48,0
+.L.data.5:
+    .byte 52,50,0
+.L.data.4:
+    .byte 48,0
+.L.data.3:
+    .byte 52,32,43,32,40,123,32,105,110,116,32,97,61,51,59,32,97,43,50,59,32,125,41,0
+.L.data.2:
+    .byte 105,110,116,32,97,61,51,59,32,105,110,116,32,122,61,53,59,32,97,43,122,59,0
+.L.data.1:
+    .byte 37,115,32,61,62,32,37,100,32,101,120,112,101,99,116,101,100,32,98,117,116,32,103,111,116,32,37,100,10,0
+.L.data.0:
+    .byte 37,115,32,61,62,32,37,100,10,0
+g2:
+    .zero 32
+g1:
+    .zero 8
@@ -1,90 +1,171 @@
 #include "gencc.h"
 
-char *filename;
-char *user_input;
-Token *token;
+// 診断メッセージの出力先．コンパイルサーバではジョブごとに差し替える．
+static FILE *err_stream() {
+    return ctx && ctx->errout ? ctx->errout : stderr;
+}
+
+// 1つの翻訳単位で報告するエラーの上限．0なら上限なし
+static int max_errors = 1;
+
+void set_max_errors(int n) {
+    max_errors = n;
+}
+
+// 以降のエラーでは，上限に達するまでコンパイルを打ち切らずにenvに戻る．
+// NULLを渡すと，次のエラーで打ち切るように戻す．
+void recover_errors(jmp_buf *env) {
+    ctx->recover = env;
+}
+
+// コンパイルを打ち切る．bailが設定されていればそこに戻り，そうでなければプロセスを終了する
+void abort_compile(void) {
+    if (bail)
+        longjmp(*bail, 1);
+    exit(1);
+}
+
+// 複数のエラーを報告できるときに，報告したエラーの数をまとめて表示する．
+// これ自体はエラーとして数えない
+void print_error_summary(void) {
+    if (max_errors == 1 || !ctx->nerrors)
+        return;
+    fprintf(err_stream(), "%s: %d error%s generated\n", ctx->filename, ctx->nerrors, ctx->nerrors > 1 ? "s" : "");
+}
+
+// エラーを1つ報告し終えたときに呼ぶ．
+// 回復できるならctx->recoverに戻り，そうでなければコンパイルを打ち切る．
+__attribute__((noreturn)) static void bail_out(FILE *err) {
+    funlockfile(err);
+    if (ctx) {
+        ctx->nerrors++;
+        if (ctx->recover && (max_errors == 0 || ctx->nerrors < max_errors))
+            longjmp(*ctx->recover, 1);
+    }
+    abort_compile();
+}
 
 // エラーを報告する
 void error(char *fmt, ...) {
     va_list ap;
     va_start(ap, fmt);
-    vfprintf(stderr, fmt, ap);
-    fprintf(stderr, "\n");
-    exit(1);
+    FILE *err = err_stream();
+    flockfile(err);
+    vfprintf(err, fmt, ap);
+    fprintf(err, "\n");
+    bail_out(err);
+}
+
+// 各行の先頭のオフセットの表を作る．
+// 最初に診断メッセージを出すときに1度だけ作り，入力と一緒に捨てる．
+static void build_line_table() {
+    long cap = 1024;
+    long n = 0;
+    unsigned *starts = malloc(sizeof(unsigned) * cap);
+    starts[n++] = 0;
+
+    char *input = ctx->user_input;
+    for (char *p = input; (p = strchr(p, '\n')); p++) {
+        if (n == cap) {
+            cap *= 2;
+            starts = realloc(starts, sizeof(unsigned) * cap);
+        }
+        starts[n++] = p + 1 - input;
+    }
+    ctx->line_starts = starts;
+    ctx->nlines = n;
+}
+
+// locを含む行の番号（0始まり）を二分探索で求める
+static long find_line(unsigned loc) {
+    if (!ctx->line_starts)
+        build_line_table();
+
+    long lo = 0;
+    long hi = ctx->nlines - 1;
+    while (lo < hi) {
+        long mid = (lo + hi + 1) / 2;
+        if (ctx->line_starts[mid] <= loc)
+            lo = mid;
+        else
+            hi = mid - 1;
+    }
+    return lo;
+}
+
+void free_line_table(Context *c) {
+    free(c->line_starts);
+    c->line_starts = NULL;
+    c->nlines = 0;
 }
 
 // エラー箇所を報告する
-void verror_at(char *loc, char *fmt, va_list ap) {
-    // find a line containing 'loc'
-    char *line = loc;
-    while (user_input < line && line[-1] != '\n')
-        line--;
-
-    char *end = loc;
-    while (*end != '\n')
+__attribute__((noreturn)) static void verror_at(unsigned loc, char *fmt, va_list ap) {
+    long line_num = find_line(loc);
+    char *line = ctx->user_input + ctx->line_starts[line_num];
+    char *end = line;
+    while (*end && *end != '\n')
         end++;
 
-    // get a line number
-    int line_num = 1;
-    for (char *p = user_input; p < line; p++)
-        if (*p == '\n')
-            line_num++;
-
     // print out the line
-    int indent = fprintf(stderr, "%s:%d: ", filename, line_num);
-    fprintf(stderr, "%.*s\n", (int)(end - line), line);
+    FILE *err = err_stream();
+    flockfile(err);
+    int indent = fprintf(err, "%s:%ld: ", ctx->filename, line_num + 1);
+    fprintf(err, "%.*s\n", (int)(end - line), line);
 
     // show the error message
-    long pos = loc - line + indent;
-    fprintf(stderr, "%s\n", user_input);
-    fprintf(stderr, "%*s", (int)pos, ""); // pos個の空白を出力
-    fprintf(stderr, "^ ");
-    vfprintf(stderr, fmt, ap);
-    fprintf(stderr, "\n");
-    exit(1);
+    long pos = ctx->user_input + loc - line + indent;
+    fprintf(err, "%*s", (int)pos, ""); // pos個の空白を出力
+    fprintf(err, "^ ");
+    vfprintf(err, fmt, ap);
+    fprintf(err, "\n");
+    bail_out(err);
 }
 
 void error_at(char *loc, char *fmt, ...) {
     va_list ap;
     va_start(ap, fmt);
-    verror_at(loc, fmt, ap);
+    verror_at(loc - ctx->user_input, fmt, ap);
 }
 
 void error_tok(Token *tok, char *fmt, ...) {
     va_list ap;
     va_start(ap, fmt);
     if (tok)
-        verror_at(tok->str, fmt, ap);
+        verror_at(tok->loc, fmt, ap);
 
-    vfprintf(stderr, fmt, ap);
-    fprintf(stderr, "\n");
-    exit(1);
+    FILE *err = err_stream();
+    flockfile(err);
+    vfprintf(err, fmt, ap);
+    fprintf(err, "\n");
+    bail_out(err);
 }
 
 // 次のトークンが期待している記号のときは，そのトークンを返す
 Token *peek(char *s) {
-    if (token->kind != TK_RESERVED || strlen(s) != token->len || memcmp(token->str, s, token->len) != 0)
+    Token *tok = ctx->token;
+    if (tok->kind != TK_RESERVED || strlen(s) != tok->len || memcmp(TOK_STR(tok), s, tok->len) != 0)
         return NULL;
-    return token;
+    return tok;
 }
 
 // 次のトークンが期待している記号のときは，トークンを1つ読み進めて真を返す．
 Token *consume(char *s) {
     if (!peek(s))
         return NULL;
-    Token *t = token;
-    token = token->next;
+    Token *t = ctx->token;
+    ctx->token = ctx->token->next;
     return t;
 }
 
 // 次のトークンが識別子の場合，トークンを1つ読み進めてそのトークンを返す．
 Token *consume_ident() {
-    if (token->kind != TK_IDENT) {
+    if (ctx->token->kind != TK_IDENT) {
         return NULL;
     }
 
-    Token *t = token;
-    token = token->next;
+    Token *t = ctx->token;
+    ctx->token = ctx->token->next;
     return t;
 }
 
@@ -92,90 +173,194 @@ Token *consume_ident() {
 // それ以外の場合にはエラーを報告する．
 void expect(char *s) {
     if (!peek(s))
-        error_tok(token, "expected \"%s\"", s);
+        error_tok(ctx->token, "expected \"%s\"", s);
 
-    token = token->next;
+    ctx->token = ctx->token->next;
 }
 
 // 次のトークンが数値の場合，トークンを1つ読み進めてその数値を返す．
 // それ以外の場合にはエラーを報告する．
 long expect_number() {
-    if (token->kind != TK_NUM) {
-        error_tok(token, "not a number");
+    if (ctx->token->kind != TK_NUM) {
+        error_tok(ctx->token, "not a number");
     }
 
-    long val = token->val;
-    token = token->next;
+    long val = ctx->token->val;
+    ctx->token = ctx->token->next;
     return val;
 }
 
 char *expect_ident() {
-    if (token->kind != TK_IDENT)
-        error_tok(token, "expected an identifier");
+    if (ctx->token->kind != TK_IDENT)
+        error_tok(ctx->token, "expected an identifier");
 
-    char *s = strndup(token->str, token->len);
-    token = token->next;
+    char *s = ctx->token->name;
+    ctx->token = ctx->token->next;
     return s;
 }
 
 // 次のトークンがEOFの場合，真を返す．
 bool at_eof() {
-    return token->kind == TK_EOF;
+    return ctx->token->kind == TK_EOF;
 }
 
 // 新しいトークンを作成してcurに繋げる．
 Token *new_token(TokenKind kind, Token *cur, char *str, long len) {
-    Token *tok = calloc(1, sizeof(Token));
+    Token *tok = arena_alloc(&ctx->tok_arena, sizeof(Token));
     tok->kind = kind;
-    tok->str = str;
+    tok->loc = str - ctx->user_input;
     tok->len = len;
     cur->next = tok;
     return tok;
 }
 
-// 入力文字列pが文字列qで始まるかどうかを返す．
-bool startswith(char *p, char *q) {
-    return memcmp(p, q, strlen(q)) == 0;
+//
+// 識別子のインターン
+//
+// 同じ綴りの識別子には同じポインタを割り当てるので，
+// 以降の名前の比較はポインタの比較だけで済む．
+//
+
+struct InternEntry {
+    char *name;
+    long len;
+    unsigned hash;
+};
+
+// FNV-1a
+static unsigned hash_string(char *p, long len) {
+    unsigned h = 2166136261u;
+    for (long i = 0; i < len; i++)
+        h = (h ^ (unsigned char)p[i]) * 16777619u;
+    return h;
 }
 
-char *startswith_keyword(char *p) {
-    // keyword
-    static char *kw[] = { "return", "if", "else", "while", "for", "int",
-                          "sizeof", "char", "struct" };
+// 表を2倍に広げて入れ直す
+static void grow_intern_table() {
+    InternTable *t = &ctx->intern;
+    long cap = t->cap ? t->cap * 2 : 4096;
+    InternEntry *table = calloc(cap, sizeof(InternEntry));
 
-    for (int i = 0; i < sizeof(kw) / sizeof(*kw); i++) {
-        size_t len = strlen(kw[i]);
-        if (startswith(p, kw[i]) && !isalnum(p[len]))
-            return kw[i];
+    for (long i = 0; i < t->cap; i++) {
+        InternEntry *e = &t->entries[i];
+        if (!e->name)
+            continue;
+        long j = e->hash & (cap - 1);
+        while (table[j].name)
+            j = (j + 1) & (cap - 1);
+        table[j] = *e;
     }
 
-    // multi-letter puncture
-    static char *ops[] = { "==", "!=", "<=", ">="};
+    free(t->entries);
+    t->entries = table;
+    t->cap = cap;
+}
 
-    for (int i = 0; i < sizeof(ops) / sizeof(*ops); i++) {
-        if (startswith(p, ops[i]))
-            return ops[i];
-    }
+// 表を空にする．確保した領域は次の翻訳単位で使い回す．
+void reset_intern_table() {
+    InternTable *t = &ctx->intern;
+    memset(t->entries, 0, sizeof(InternEntry) * t->cap);
+    t->used = 0;
+}
 
-    return NULL;
+// 表を捨てる．文字列はintern_arenaと一緒に解放する．
+void free_intern_table() {
+    free(ctx->intern.entries);
+    ctx->intern = (InternTable){0};
 }
 
-// 指定した長さの文字列をコピーする
-char *strndup(char *p, long len) {
-    char *buf = malloc(len + 1);
-    strncpy(buf, p, len);
-    buf[len] = '\0';
-    return buf;
+// p[0..len)と同じ綴りの文字列を表から探し，なければ登録する．
+char *intern(char *p, long len) {
+    InternTable *t = &ctx->intern;
+    if (t->used * 2 >= t->cap)
+        grow_intern_table();
+
+    unsigned h = hash_string(p, len);
+    long i = h & (t->cap - 1);
+    for (;;) {
+        InternEntry *e = &t->entries[i];
+        if (!e->name) {
+            e->name = arena_strndup(&ctx->intern_arena, p, len);
+            e->len = len;
+            e->hash = h;
+            t->used++;
+            return e->name;
+        }
+        if (e->hash == h && e->len == len && !memcmp(e->name, p, len))
+            return e->name;
+        i = (i + 1) & (t->cap - 1);
+    }
 }
 
-// [a-z] or [A-Z] or '_' ならtrueを返す
-bool is_alpha(char c) {
-    return ('a' <= c && c <= 'z') || ('A' <= c && c <= 'Z') || c == '_';
+// 文字の種類
+enum {
+    C_SPACE = 1,  // 空白文字
+    C_DIGIT = 2,  // [0-9]
+    C_ALPHA = 4,  // [a-z] or [A-Z] or '_'
+    C_PUNCT = 8,  // 1文字の記号
+    C_EQ    = 16, // 後ろに'='が続くと2文字の記号になる
+};
+
+#define S C_SPACE
+#define D C_DIGIT
+#define A C_ALPHA
+#define P C_PUNCT
+#define E C_EQ
+
+// 文字の種類を引く表．0x80以降はすべて0．
+static const unsigned char char_class[256] = {
+    0, 0, 0, 0, 0, 0, 0, 0,                                 // 0x00
+    0, S, S, S, S, S, 0, 0,                                 // 0x08
+    0, 0, 0, 0, 0, 0, 0, 0,                                 // 0x10
+    0, 0, 0, 0, 0, 0, 0, 0,                                 // 0x18
+    S, E, 0, 0, 0, 0, P, 0,                                 // 0x20  !"#$%&'
+    P, P, P, P, P, P, P, P,                                 // 0x28 ()*+,-./
+    D, D, D, D, D, D, D, D,                                 // 0x30 01234567
+    D, D, 0, P, P|E, P|E, P|E, 0,                           // 0x38 89:;<=>?
+    0, A, A, A, A, A, A, A,                                 // 0x40 @ABCDEFG
+    A, A, A, A, A, A, A, A,                                 // 0x48 HIJKLMNO
+    A, A, A, A, A, A, A, A,                                 // 0x50 PQRSTUVW
+    A, A, A, P, 0, P, 0, A,                                 // 0x58 XYZ[\]^_
+    0, A, A, A, A, A, A, A,                                 // 0x60 `abcdefg
+    A, A, A, A, A, A, A, A,                                 // 0x68 hijklmno
+    A, A, A, A, A, A, A, A,                                 // 0x70 pqrstuvw
+    A, A, A, P, 0, P, 0, 0,                                 // 0x78 xyz{|}~
+};
+
+#undef S
+#undef D
+#undef A
+#undef P
+#undef E
+
+// キーワードの完全ハッシュ関数．
+// キーワードごとに異なる値になるように係数を選んである．
+static int kw_hash(char *p, long len) {
+    return ((unsigned char)p[0] + (unsigned char)p[len - 1] + (len << 2)) & 15;
 }
 
-// [a-z] or [A-Z] or [0-9] or '_' ならtrueを返す
-bool is_alnum(char c) {
-    return is_alpha(c) || ('0' <= c && c <= '9');
+// kw_hashの値で引くキーワード表
+static char *kw_table[16] = {
+    [0] = "while",
+    [1] = "sizeof",
+    [4] = "for",
+    [5] = "char",
+    [7] = "if",
+    [8] = "return",
+    [9] = "int",
+    [10] = "else",
+    [15] = "struct",
+};
+
+// 識別子p[0..len)がキーワードかどうかを返す．
+static bool is_keyword(char *p, long len) {
+    char *kw = kw_table[kw_hash(p, len)];
+    return kw && strlen(kw) == len && !memcmp(p, kw, len);
+}
+
+// 空白文字ならtrueを返す
+static bool is_space(char c) {
+    return char_class[(unsigned char)c] & C_SPACE;
 }
 
 char get_escape_char(char c) {
@@ -215,51 +400,86 @@ Token *read_string_literal(Token *cur, char *start) {
     }
 
     Token *tok = new_token(TK_STR, cur, start, p - start + 1);
-    tok->contents = malloc(len + 1);
-    memcpy(tok->contents, buf, len);
-    tok->contents[len] = '\0';
+    tok->contents = arena_strndup(&ctx->tok_arena, buf, len);
     tok->cont_len = len + 1;
     return tok;
 }
 
-// "user_input"をトークナイズしてそれを返す．
-Token *tokenize() {
-    char *p = user_input;
+// "user_input"の続きをトークナイズして，末尾にTK_EOFを付けて返す．
+// one_declが真なら，トップレベルの宣言を1つ読んだところで止める．
+// 宣言は深さ0の";"か，関数本体を閉じる"}"で終わる．
+static Token *tokenize_input(bool one_decl) {
+    char *p = ctx->input_pos ? ctx->input_pos : ctx->user_input;
     Token head;
     head.next = NULL;
     Token *cur = &head;
+    long depth = 0;        // "{"の深さ
+    bool fn_body = false;  // 深さ0の"{"が関数本体を開いたか
 
     while (*p) {
+        int cls = char_class[(unsigned char)*p];
+
         // 空白文字をスキップ
-        if (isspace(*p)) {
+        if (cls & C_SPACE) {
             p++;
+            if (is_space(*p))
+                p = skip_space(p);
             continue;
         }
 
-        if (startswith(p, "//")) {
-            p += 2;
-            while (*p != '\n') p++;
+        // 識別子かキーワード
+        if (cls & C_ALPHA) {
+            char *q = p;
+            p = skip_ident(p + 1);
+            if (is_keyword(q, p - q)) {
+                cur = new_token(TK_RESERVED, cur, q, p - q);
+            } else {
+                cur = new_token(TK_IDENT, cur, q, p - q);
+                cur->name = intern(q, p - q);
+            }
+            continue;
+        }
+
+        if (cls & C_DIGIT) {
+            char *q = p;
+            p = skip_digit(p + 1);
+            cur = new_token(TK_NUM, cur, q, p - q);
+            for (char *r = q; r < p; r++)
+                cur->val = cur->val * 10 + (*r - '0');
+            continue;
+        }
+
+        if (*p == '/' && p[1] == '/') {
+            p = skip_line(p + 2);
             continue;
         }
 
-        if (startswith(p, "/*")) {
-            char *q = strstr(p + 2, "*/");
+        if (*p == '/' && p[1] == '*') {
+            char *q = find_comment_end(p + 2);
             if (!q)
                 error_at(p, "unclosed block comment");
             p = q + 2;
             continue;
         }
 
-        char *kw = startswith_keyword(p);
-        if (kw) {
-            size_t len = strlen(kw);
-            cur = new_token(TK_RESERVED, cur, p, (long)len);
-            p += len;
+        // "==", "!=", "<=", ">="
+        if ((cls & C_EQ) && p[1] == '=') {
+            cur = new_token(TK_RESERVED, cur, p, 2);
+            p += 2;
             continue;
         }
 
-        if (strchr("+-*/()<>;={},&[].", *p)) {
+        if (cls & C_PUNCT) {
+            Token *prev = cur;
             cur = new_token(TK_RESERVED, cur, p++, 1);
+            if (!one_decl)
+                continue;
+
+            char c = p[-1];
+            if (c == '{' && depth++ == 0)
+                fn_body = prev != &head && prev->len == 1 && *TOK_STR(prev) == ')';
+            if ((c == '}' && depth > 0 && --depth == 0 && fn_body) || (c == ';' && depth == 0))
+                break;
             continue;
         }
 
@@ -270,26 +490,22 @@ Token *tokenize() {
             continue;
         }
 
-        if (isdigit(*p)) {
-            cur = new_token(TK_NUM, cur, p, 0);
-            char *q = p;
-            cur->val = strtol(p, &p, 10);
-            cur->len = p - q;
-            continue;
-        }
-
-        if (is_alpha(*p)) {
-            char *q = p++;
-            while (is_alnum(*p)) {
-                p++;
-            }
-            cur = new_token(TK_IDENT, cur, q, p - q);
-            continue;
-        }
-
         error_at(p, "invalid token");
     }
 
     new_token(TK_EOF, cur, p, 0);
+    ctx->input_pos = p;
     return head.next;
 }
+
+// "user_input"の全体をトークナイズしてそれを返す．
+Token *tokenize() {
+    ctx->input_pos = NULL;
+    return tokenize_input(false);
+}
+
+// まだトークナイズしていない部分から，トップレベルの宣言を1つ分だけトークナイズする．
+// 入力の終わりではTK_EOFだけを返す．
+Token *tokenize_decl() {
+    return tokenize_input(true);
+}
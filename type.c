@@ -1,74 +1,167 @@
 #include "gencc.h"
 
 Type *new_type(TypeKind kind) {
-    Type *ty = calloc(1, sizeof(Type));
+    Type *ty = arena_alloc(&ctx->type_arena, sizeof(Type));
     ty->kind = kind;
     return ty;
 }
 
 Type *char_type() {
-    return new_type(TY_CHAR);
+    static Type ty = { TY_CHAR, 1 };
+    return &ty;
 }
 
 Type *int_type() {
-    return new_type(TY_INT);
+    static Type ty = { TY_INT, 8 };
+    return &ty;
 }
 
-Type *pointer_to(Type *base) {
-    Type *ty = new_type(TY_PTR);
+//
+// 派生型の表
+//
+// (kind, base, array_size)が同じポインタ型・配列型は1つのTypeを共有する．
+//
+
+static unsigned long hash_type(TypeKind kind, Type *base, long array_size) {
+    unsigned long h = ((unsigned long)base >> 3) * 0x9E3779B97F4A7C15ul;
+    return (h ^ (array_size * 31 + kind)) * 0x9E3779B97F4A7C15ul >> 16;
+}
+
+// 表を2倍に広げて入れ直す
+static void grow_derived_types() {
+    TypeTable *t = &ctx->types;
+    long cap = t->cap ? t->cap * 2 : 1024;
+    Type **table = calloc(cap, sizeof(Type *));
+
+    for (long i = 0; i < t->cap; i++) {
+        Type *ty = t->types[i];
+        if (!ty)
+            continue;
+        long j = hash_type(ty->kind, ty->base, ty->array_size) & (cap - 1);
+        while (table[j])
+            j = (j + 1) & (cap - 1);
+        table[j] = ty;
+    }
+
+    free(t->types);
+    t->types = table;
+    t->cap = cap;
+}
+
+// 表を空にする．確保した領域は次の翻訳単位で使い回す．
+void reset_type_table() {
+    TypeTable *t = &ctx->types;
+    memset(t->types, 0, sizeof(Type *) * t->cap);
+    t->used = 0;
+}
+
+// 表を捨てる．型はtype_arenaと一緒に解放する．
+void free_type_table() {
+    free(ctx->types.types);
+    ctx->types = (TypeTable){0};
+}
+
+// 派生型を表から探し，なければ作って登録する．
+static Type *derived_type(TypeKind kind, Type *base, long array_size) {
+    TypeTable *t = &ctx->types;
+    if (t->used * 2 >= t->cap)
+        grow_derived_types();
+
+    long i = hash_type(kind, base, array_size) & (t->cap - 1);
+    for (;;) {
+        Type *ty = t->types[i];
+        if (!ty)
+            break;
+        if (ty->kind == kind && ty->base == base && ty->array_size == array_size)
+            return ty;
+        i = (i + 1) & (t->cap - 1);
+    }
+
+    Type *ty = new_type(kind);
     ty->base = base;
+    ty->array_size = array_size;
+    ty->size = (kind == TY_PTR) ? 8 : base->size * array_size;
+    t->types[i] = ty;
+    t->used++;
     return ty;
 }
 
+Type *pointer_to(Type *base) {
+    return derived_type(TY_PTR, base, 0);
+}
+
 Type *array_of(Type *base, long size) {
-    Type *ty = new_type(TY_ARRAY);
-    ty->base = base;
-    ty->array_size = size;
-    return ty;
+    return derived_type(TY_ARRAY, base, size);
 }
 
 long size_of(Type *ty) {
-    switch (ty->kind) {
-        case TY_CHAR:
-            return 1;
-        case TY_INT:
-        case TY_PTR:
-            return 8;
-        case TY_ARRAY:
-            return size_of(ty->base) * ty->array_size;
-        case TY_STRUCT: {
-            Member *mem = ty->members;
-            while (mem->next)
-                mem = mem->next;
-            return mem->offset + size_of(mem->ty);
-        }
+    return ty->size;
+}
+
+static unsigned long hash_name(char *name) {
+    return ((unsigned long)name >> 3) * 0x9E3779B97F4A7C15ul >> 32;
+}
+
+// 構造体のメンバ名の索引を作る．
+// 同じ名前のメンバが複数あるときは先に宣言したものを引く．
+void build_member_index(Type *ty) {
+    long n = 0;
+    for (Member *mem = ty->members; mem; mem = mem->next)
+        n++;
+
+    long cap = 8;
+    while (cap < n * 2)
+        cap *= 2;
+    ty->member_index = arena_alloc(&ctx->type_arena, sizeof(Member *) * cap);
+    ty->member_cap = cap;
+
+    for (Member *mem = ty->members; mem; mem = mem->next) {
+        long i = hash_name(mem->name) & (cap - 1);
+        while (ty->member_index[i] && ty->member_index[i]->name != mem->name)
+            i = (i + 1) & (cap - 1);
+        if (!ty->member_index[i])
+            ty->member_index[i] = mem;
     }
-    error("unknown type");
 }
 
 Member *find_member(Type *ty, char *name) {
-    for (Member *mem = ty->members; mem; mem = mem->next)
-        if (!strcmp(mem->name, name))
+    long i = hash_name(name) & (ty->member_cap - 1);
+    for (;;) {
+        Member *mem = ty->member_index[i];
+        if (!mem || mem->name == name)
             return mem;
-    return NULL;
+        i = (i + 1) & (ty->member_cap - 1);
+    }
 }
 
-void visit(Node *node) {
-    if (!node)
-        return;
-
-    visit(node->lhs);
-    visit(node->rhs);
-    visit(node->cond);
-    visit(node->then);
-    visit(node->els);
-    visit(node->init);
-    visit(node->inc);
+// アドレスを計算できる式でなければエラーにする．
+// コード生成の途中でエラーにならないように，ここで調べておく．
+static void check_addressable(Node *node) {
+    if (node->kind != ND_VAR && node->kind != ND_DEREF && node->kind != ND_MEMBER)
+        error_tok(node->tok, "not a variable");
+}
 
-    for (Node *n = node->body; n; n = n->next)
-        visit(n);
-    for (Node *n = node->args; n; n = n->next)
-        visit(n);
+// ノードに型を付ける．
+// パーサがノードを作るたびに呼ぶので，子ノードにはすでに型が付いている．
+void add_type(Node *node) {
+    // lhsとrhsは種類によっては他のフィールドと重なっているので，使う種類でだけ引く
+    Node *lhs = NULL;
+    Node *rhs = NULL;
+    switch (node->kind) {
+        case ND_ADD:
+        case ND_SUB:
+        case ND_ASSIGN:
+            rhs = NODE(node->rhs);
+            // fallthrough
+        case ND_MEMBER:
+        case ND_ADDR:
+        case ND_DEREF:
+        case ND_SIZEOF:
+            lhs = NODE(node->lhs);
+            break;
+        default:
+            break;
+    }
 
     switch(node->kind) {
         case ND_MUL:
@@ -86,55 +179,59 @@ void visit(Node *node) {
             return;
         case ND_ADD:
             // if x + ptr then ptr + x
-            if (node->rhs->ty->base) {
-                Node *tmp = node->lhs;
+            if (rhs->ty->base) {
+                NodeId tmp = node->lhs;
                 node->lhs = node->rhs;
                 node->rhs = tmp;
+                rhs = lhs;
+                lhs = NODE(node->lhs);
             }
-            if (node->rhs->ty->base)
+            if (rhs->ty->base)
                 error_tok(node->tok, "invalid pointer arithmetic operands"); // can't x + ptr
-            node->ty = node->lhs->ty;
+            node->ty = lhs->ty;
             return;
         case ND_SUB:
-            if (node->rhs->ty->base)
+            if (rhs->ty->base)
                 error_tok(node->tok, "invalid pointer arithmetic operands"); // can't x - ptr
-            node->ty = node->lhs->ty;
+            node->ty = lhs->ty;
             return;
         case ND_ASSIGN:
-            node->ty = node->lhs->ty;
+            if (lhs->ty->kind == TY_ARRAY)
+                error_tok(lhs->tok, "not an lvalue");
+            check_addressable(lhs);
+            node->ty = lhs->ty;
             return;
         case ND_MEMBER:
-            if (node->lhs->ty->kind != TY_STRUCT)
-                error_tok(node->tok, "not a struct");
-            node->member = find_member(node->lhs->ty, node->member_name);
-            if (!node->member)
-                error_tok(node->tok, "no such member");
+            // メンバはパーサが引いておく
+            check_addressable(lhs);
             node->ty = node->member->ty;
             return;
         case ND_ADDR:
-            if (node->lhs->ty->kind == TY_ARRAY)
-                node->ty = pointer_to(node->lhs->ty->base);
+            check_addressable(lhs);
+            if (lhs->ty->kind == TY_ARRAY)
+                node->ty = pointer_to(lhs->ty->base);
             else
-                node->ty = pointer_to(node->lhs->ty);
+                node->ty = pointer_to(lhs->ty);
             return;
         case ND_DEREF:
-            if (!node->lhs->ty->base)
+            if (!lhs->ty->base)
                 error_tok(node->tok, "invalid pointer dereference");
-            node->ty = node->lhs->ty->base;
+            node->ty = lhs->ty->base;
             return;
         case ND_SIZEOF:
             node->kind = ND_NUM;
             node->ty = int_type();
-            node->val = size_of(node->lhs->ty);
-            node->lhs = NULL;
+            node->val = size_of(lhs->ty); // valはlhsと重なっている
+            return;
+        case ND_STMT_EXPR: {
+            // 最後の式文の値が全体の値になる
+            Node *last = NODE(node->body);
+            while (last->next)
+                last = NODE(last->next);
+            node->ty = last->ty;
             return;
+        }
         default:
             return;
     }
 }
-
-void add_type(Program *prog) {
-    for (Function *fn = prog->fns; fn; fn = fn->next)
-        for (Node *node = fn->node; node; node = node->next)
-            visit(node);
-}
\ No newline at end of file